@@ -0,0 +1,218 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "benchmark.hh"
+#include "common/Datime.hh"
+#include "model/category.hh"
+#include "model/CategoryIndex.hh"
+#include "model/note.hh"
+#include "sqlite/sqlite.hh"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /// Average time (in milliseconds) of one call of 'fn'.
+    double measure(int const repeat, std::function<void()> const& fn) noexcept {
+        fn();   // warm up (statement cache, page cache)
+        auto const start = Clock::now();
+        for (int i = 0; i < repeat; ++i)
+            fn();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeat;
+    }
+
+    /// Previous implementation of Category::idsSubchainFor - one query per category.
+    std::vector<i64> perNodeSubchain(i64 const id) noexcept {
+        using ChildrenQuery = sql::query<"SELECT id FROM category WHERE pid=?", i64>;
+        std::vector<i64> ids{id};
+        if (auto children = SQLite::instance().fetch<ChildrenQuery>(id); children)
+            for (auto const& [childID] : *children) {
+                auto data = perNodeSubchain(childID);
+                ids.insert(ids.end(), data.begin(), data.end());
+            }
+        std::ranges::sort(ids);
+        return ids;
+    }
+
+    /// Previous implementation of DateTime(std::string) - stream, date::parse, zone lookup
+    /// (ambiguous times at the end of summer time are resolved as in DateTime).
+    i64 streamParse(std::string const& text) {
+        std::stringstream in{text};
+        date::local_time<std::chrono::seconds> tp;
+        in >> date::parse("%F %T", tp);
+        auto const zoned = date::make_zoned(date::locate_zone("Europe/Warsaw"), tp, date::choose::earliest);
+        return zoned.get_sys_time().time_since_epoch().count();
+    }
+
+    /// Previous implementation of DateTime::str() - stream.
+    std::string streamFormat(i64 const timestamp) {
+        auto const tp = std::chrono::system_clock::from_time_t(timestamp);
+        auto const zoned = date::make_zoned(date::locate_zone("Europe/Warsaw"), std::chrono::floor<std::chrono::seconds>(tp));
+        std::stringstream ss{};
+        ss << zoned.get_local_time();
+        return ss.str();
+    }
+
+    i64 addCategory(i64 const pid, std::string const& name) noexcept {
+        return SQLite::instance().insert("INSERT INTO category (pid, name) VALUES (?,?)", pid, name);
+    }
+
+    bool addNotes(i64 const pid, int const count, std::string const& content) noexcept {
+        for (int i = 0; i < count; ++i) {
+            auto const title = fmt::format("note {}", i);
+            if (SQLite::InvalidRowid == SQLite::instance().insert(
+                    "INSERT INTO note (pid, title, description, content) VALUES (?,?,?,?)",
+                    pid, value_t::ref(title), "benchmark", value_t::ref(content)))
+                return false;
+        }
+        return true;
+    }
+
+    /// Deep tree: 50 chains of 20 levels, 5 notes in every category.
+    /// \return ID of the main category of the first chain.
+    i64 deepTree(std::string const& content) noexcept {
+        i64 first{};
+        for (int chain = 0; chain < 50; ++chain) {
+            i64 pid{};
+            for (int level = 0; level < 20; ++level) {
+                auto const id = addCategory(pid, fmt::format("deep {}.{}", chain, level));
+                if (id == SQLite::InvalidRowid or not addNotes(id, 5, content))
+                    return {};
+                if (chain == 0 and level == 0)
+                    first = id;
+                pid = id;
+            }
+        }
+        return first;
+    }
+
+    /// Wide tree: one main category with 5000 subcategories, 2 notes in every subcategory.
+    /// \return ID of the main category.
+    i64 wideTree(std::string const& content) noexcept {
+        auto const root = addCategory(0, "wide");
+        for (int i = 0; i < 5000; ++i) {
+            auto const id = addCategory(root, fmt::format("wide {}", i));
+            if (id == SQLite::InvalidRowid or not addNotes(id, 2, content))
+                return {};
+        }
+        return root;
+    }
+
+    void compare(std::string_view const name, i64 const categoryID, int const repeat) noexcept {
+        std::size_t count{};
+        auto const counter = [&count](Note&&) { ++count; };
+
+        auto const perNode = measure(repeat, [&] {
+            count = 0;
+            Note::forEach(perNodeSubchain(categoryID), counter);
+        });
+        auto const index = measure(repeat, [&] {
+            count = 0;
+            Note::forEach(CategoryIndex::instance().subtree(categoryID), counter);
+        });
+        auto const cte = measure(repeat, [&] {
+            count = 0;
+            Note::forEachInSubtree(categoryID, counter);
+        });
+
+        fmt::print("{} tree ({} notes):\n", name, count);
+        fmt::print("    per-node SQL + IN list: {:8.3f} ms\n", perNode);
+        fmt::print("    category index + IN:    {:8.3f} ms\n", index);
+        fmt::print("    recursive CTE:          {:8.3f} ms\n", cte);
+    }
+}
+
+namespace bench {
+    int subtree() noexcept {
+        auto& db = SQLite::instance();
+        auto const ok = db.create(SQLite::InMemory, [](SQLite const& db) {
+            for (auto const* commands : {&Category::CreationCmd, &Note::CreationCmd})
+                for (auto const& cmd : *commands)
+                    if (not db.exec(cmd))
+                        return false;
+            return true;
+        });
+        if (not ok)
+            return 1;
+
+        std::string const content(1024, 'x');
+        if (not db.exec("BEGIN"))
+            return 1;
+        auto const deep = deepTree(content);
+        auto const wide = wideTree(content);
+        if (not db.exec("COMMIT") or not deep or not wide)
+            return 1;
+
+        compare("deep", deep, 200);
+        compare("wide", wide, 10);
+        return 0;
+    }
+}
+
+namespace bench {
+    int datetime() noexcept {
+        // Dates every ~16 minutes from 2022-01-01 (crossing changes of summer time).
+        std::vector<i64> timestamps{};
+        std::vector<std::string> texts{};
+        for (i64 i = 0, ts = 1640995200; i < 100'000; ++i, ts += 947) {
+            timestamps.push_back(ts);
+            texts.push_back(DateTime(ts).str());
+        }
+        std::vector<DateTime> items{};
+        for (auto const& text : texts)
+            items.emplace_back(std::string_view{text});
+
+        // Both implementations must give the same results.
+        for (std::size_t i = 0; i < texts.size(); i += 97)
+            if (streamParse(texts[i]) != items[i].timestamp() or streamFormat(timestamps[i]) != texts[i]) {
+                fmt::print(stderr, "DateTime differs from the previous implementation: {}\n", texts[i]);
+                return 1;
+            }
+
+        i64 sum{};
+        auto const streamFrom = measure(5, [&] {
+            for (auto const& text : texts)
+                sum += streamParse(text);
+        });
+        auto const viewFrom = measure(5, [&] {
+            for (auto const& text : texts)
+                sum += DateTime(std::string_view{text}).timestamp();
+        });
+        auto const batchFrom = measure(5, [&] {
+            for (auto const& item : DateTime::from_strings(texts))
+                sum += item->timestamp();
+        });
+
+        std::size_t size{};
+        auto const streamTo = measure(5, [&] {
+            for (auto const ts : timestamps)
+                size += streamFormat(ts).size();
+        });
+        auto const viewTo = measure(5, [&] {
+            for (auto const& item : items)
+                size += item.str().size();
+        });
+        auto const batchTo = measure(5, [&] {
+            for (auto const& text : DateTime::to_strings(items))
+                size += text.size();
+        });
+
+        fmt::print("DateTime, {} dates (checksum {}, {}):\n", texts.size(), sum, size);
+        fmt::print("    parse  - stream + date::parse: {:8.3f} ms\n", streamFrom);
+        fmt::print("    parse  - string_view parser:   {:8.3f} ms\n", viewFrom);
+        fmt::print("    parse  - batch (from_strings): {:8.3f} ms\n", batchFrom);
+        fmt::print("    format - stream:               {:8.3f} ms\n", streamTo);
+        fmt::print("    format - formatter:            {:8.3f} ms\n", viewTo);
+        fmt::print("    format - batch (to_strings):   {:8.3f} ms\n", batchTo);
+        return 0;
+    }
+}
@@ -0,0 +1,20 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+/// Benchmarks run from the command line (without GUI) on an in-memory database.
+namespace bench {
+    /// Listing of notes of a category subtree:
+    ///     per-node SQL recursion + IN list (the previous implementation),
+    ///     in-memory category index + IN list,
+    ///     one recursive CTE query,
+    /// on a deep (20 levels) and a wide (5000 categories) synthetic tree.
+    int subtree() noexcept;
+
+    /// DateTime from/to text ("%F %T") for 100 000 dates spread over 3 years:
+    ///     streams + date::parse, zone located per object (the previous implementation),
+    ///     string_view parser/formatter with the cached zone,
+    ///     batch conversion (from_strings/to_strings).
+    int datetime() noexcept;
+}
@@ -0,0 +1,88 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "DatabaseExecutor.hh"
+#include "../sqlite/sqlite.hh"
+#include <algorithm>
+#include <future>
+#include <fmt/core.h>
+
+bool DatabaseExecutor::
+start(fs::path const& path, std::size_t const readers) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_)
+        return true;
+
+    // Połączenie jest otwierane w wątku, który będzie go używał (każdy wątek ma własne).
+    for (std::size_t i = 0; i < std::max<std::size_t>(readers, 1); ++i) {
+        std::promise<bool> opened{};
+        auto result = opened.get_future();
+        std::thread thread([this, path, &opened] {
+            auto const ok = SQLite::instance().open(path, true);
+            opened.set_value(ok);
+            if (ok)
+                loop();
+        });
+        if (result.get())
+            threads_.push_back(std::move(thread));
+        else {
+            thread.join();
+            fmt::print(stderr, "The database thread could not be started.\n");
+            break;
+        }
+    }
+    running_ = not threads_.empty();
+    return running_;
+}
+
+void DatabaseExecutor::
+stop() noexcept {
+    std::vector<std::thread> threads{};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (not running_)
+            return;
+        running_ = false;
+        threads = std::move(threads_);
+        threads_.clear();
+    }
+    cv_.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void DatabaseExecutor::
+enqueue(std::function<void()> task) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            tasks_.push_back(std::move(task));
+            cv_.notify_one();
+            return;
+        }
+    }
+    // Wątki nie działają - wykonujemy zlecenie od razu (połączenie wątku wywołującego).
+    task();
+}
+
+/// Wykonywanie zleceń aż do zatrzymania wątków
+/// (zlecenia już przyjęte są wykonywane do końca).
+void DatabaseExecutor::
+loop() noexcept {
+    for (;;) {
+        std::function<void()> task{};
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return not running_ or not tasks_.empty(); });
+            if (tasks_.empty())
+                break;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+    SQLite::instance().close();
+}
@@ -0,0 +1,106 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared.hh"
+#include "EventController.hh"
+#include <QFuture>
+#include <QPromise>
+#include <QVariant>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Threads executing database requests (reads) of the widgets. \n
+/// Every thread of the pool has its own read-only connection to the database
+/// (SQLite::instance() is thread local), so requests are executed concurrently
+/// with each other and - thanks to WAL - with writes of the GUI thread. \n
+/// Requests are taken in order of submission, their results may arrive in any order. \n
+/// Results are returned as QFuture (submit) or are sent back to the GUI
+/// thread as events through EventController (post): the event carries
+/// the ticket of the request and the result (QVariant), so a widget
+/// renders only the result of its latest request. \n
+/// If no thread is running, requests are executed immediately
+/// in the calling thread.
+class DatabaseExecutor {
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_{};
+    std::vector<std::thread> threads_{};
+    bool running_{};
+    std::atomic<u64> ticket_{};
+public:
+    static DatabaseExecutor& instance() noexcept {
+        static DatabaseExecutor executor;
+        return executor;
+    }
+
+    // no copy, no move
+    DatabaseExecutor(DatabaseExecutor const&) = delete;
+    DatabaseExecutor& operator=(DatabaseExecutor const&) = delete;
+    DatabaseExecutor(DatabaseExecutor&&) = delete;
+    DatabaseExecutor& operator=(DatabaseExecutor&&) = delete;
+    ~DatabaseExecutor() {
+        stop();
+    }
+
+    static constexpr std::size_t DefaultReaders = 2;
+
+    /// Start the threads, each with its own read-only connection to the database.
+    /// \return false if no thread could open the database.
+    bool start(fs::path const& path, std::size_t readers = DefaultReaders) noexcept;
+
+    /// Stop the threads (requests already submitted are executed first).
+    void stop() noexcept;
+
+    /// Number of running threads.
+    [[nodiscard]] std::size_t size() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threads_.size();
+    }
+
+    /// Execute 'fn' (read only) in a thread of the database.
+    /// \return future result of 'fn'.
+    template<typename Fn, typename R = std::invoke_result_t<Fn>>
+    QFuture<R> submit(Fn fn) noexcept {
+        auto const promise = std::make_shared<QPromise<R>>();
+        auto future = promise->future();
+        promise->start();
+        enqueue([promise, fn = std::move(fn)]() mutable {
+            if constexpr (std::is_void_v<R>)
+                fn();
+            else
+                promise->addResult(fn());
+            promise->finish();
+        });
+        return future;
+    }
+
+    /// Execute 'fn' (read only) in a thread of the database, the result is sent
+    /// as the event 'eventID' with arguments (ticket, QVariant(result)).
+    /// \return ticket of the request.
+    template<typename Fn>
+    u64 post(int const eventID, Fn fn) noexcept {
+        auto const ticket = ++ticket_;
+        enqueue([eventID, ticket, fn = std::move(fn)]() mutable {
+            EventController::instance().send(eventID, qint64(ticket), QVariant::fromValue(fn()));
+        });
+        return ticket;
+    }
+
+private:
+    DatabaseExecutor() = default;
+    void enqueue(std::function<void()> task) noexcept;
+    void loop() noexcept;
+};
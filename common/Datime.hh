@@ -28,7 +28,12 @@
 #include <date/date.h>
 #include <date/tz.h>
 #include <fmt/core.h>
+#include <atomic>
 #include <chrono>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <vector>
 //#include <fmt/chrono.h>
 
 using i64 = int64_t;
@@ -61,9 +66,35 @@ struct Time {
 };
 
 class DateTime final {
-    date::time_zone const* zone = date::locate_zone("Europe/Warsaw");
+    static inline std::atomic<date::time_zone const*> zone_{};
+    date::time_zone const* zone = default_zone();
     zoned_time_t tp_{};
 public:
+    static constexpr std::string_view DefaultZone = "Europe/Warsaw";
+    /// Długość tekstu w formacie "%F %T" (np. 2023-10-23 11:06:21).
+    static constexpr std::size_t TextSize = 19;
+
+    /// Strefa czasowa data-czasów (wyszukiwana w bazie stref raz dla całego programu).
+    static date::time_zone const* default_zone() {
+        auto zone = zone_.load(std::memory_order_acquire);
+        if (not zone) {
+            zone = date::locate_zone(std::string{DefaultZone});
+            zone_.store(zone, std::memory_order_release);
+        }
+        return zone;
+    }
+    /// Zmiana strefy czasowej (np. "Europe/Warsaw") - dotyczy data-czasów tworzonych później.
+    /// \return False jeśli strefa jest nieznana (strefa się nie zmienia).
+    static bool set_default_zone(std::string_view const name) noexcept {
+        try {
+            zone_.store(date::locate_zone(std::string{name}), std::memory_order_release);
+            return true;
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
     /// Data-czas teraz (now).
     DateTime() {
         auto const now = std::chrono::system_clock::now();
@@ -78,14 +109,11 @@ public:
     explicit DateTime(zoned_time_t const tp) : tp_{tp} {}
 
     /// Data-czas z tekstu (np. 2023-10-23 11:06:21).
+    /// Niepoprawny tekst daje początek epoki (czasu lokalnego).
     /// \param str - string z datą i godziną
-    explicit DateTime(std::string const& str) {
-        std::stringstream in{str};
-        date::local_time<std::chrono::seconds> tp;
-        in >> date::parse("%F %T", tp);
-//        date::from_stream(in, "%F %X", tp);
-        tp_ = make_zoned(zone, tp);
-    }
+    explicit DateTime(std::string_view const str)
+            : tp_{zone, to_sys(zone, parse(str).value_or(date::local_seconds{}))}
+    {}
 
     /// Data-czas z komponentów.
     explicit DateTime(Date const dt, Time const tm)
@@ -138,7 +166,7 @@ public:
     /// Zmiana czasu na podany.
     DateTime& set_time(Time const tm) noexcept {
         namespace chrono = std::chrono;
-        auto t = date::floor<chrono::days>(tp_.get_local_time())
+        auto t = date::floor<chrono::days>(local())
                  + chrono::hours(tm.h)
                  + chrono::minutes(tm.m)
                  + chrono::seconds(tm.s);
@@ -148,9 +176,9 @@ public:
     /// Wyzerowanie sekund z ewentualnym zaokrągleniem minut.
     DateTime& clear_seconds() noexcept {
         namespace chrono = std::chrono;
-        auto const days = date::floor<chrono::days>(tp_.get_local_time());
-        date::hh_mm_ss hms{tp_.get_local_time() - days};
-        auto t = date::floor<chrono::days>(tp_.get_local_time())
+        auto const days = date::floor<chrono::days>(local());
+        date::hh_mm_ss hms{local() - days};
+        auto t = date::floor<chrono::days>(local())
                  + hms.hours()
                  + hms.minutes()
                  + chrono::seconds(hms.seconds().count() >= 30 ? 60 : 0);
@@ -160,7 +188,7 @@ public:
     /// Wyzerowanie czasu.
     DateTime& clear_time() noexcept {
         namespace chrono = std::chrono;
-        auto t = date::floor<chrono::days>(tp_.get_local_time())
+        auto t = date::floor<chrono::days>(local())
                  + chrono::hours(0)
                  + chrono::minutes(0)
                  + chrono::seconds(0);
@@ -179,7 +207,7 @@ public:
     [[nodiscard]] Date
     date_components() const noexcept {
         namespace chrono = std::chrono;
-        auto days = date::floor<chrono::days>(tp_.get_local_time());
+        auto days = date::floor<chrono::days>(local());
         date::year_month_day ymd{days};
         auto const year = static_cast<int>(ymd.year());
         auto const month = static_cast<int>(static_cast<unsigned>(ymd.month()));
@@ -195,8 +223,8 @@ public:
     [[nodiscard]] Time
     time_components() const noexcept {
         namespace chrono = std::chrono;
-        auto const days = date::floor<chrono::days>(tp_.get_local_time());
-        date::hh_mm_ss const hms{tp_.get_local_time() - days};
+        auto const days = date::floor<chrono::days>(local());
+        date::hh_mm_ss const hms{local() - days};
         auto hour = static_cast<int>(hms.hours().count());
         auto min = static_cast<int>(hms.minutes().count());
         auto sec = static_cast<int>(hms.seconds().count());
@@ -206,7 +234,7 @@ public:
     [[nodiscard]] std::tuple<Date, Time>
     components() const noexcept {
         namespace chrono = std::chrono;
-        auto const days = date::floor<chrono::days>(tp_.get_local_time());
+        auto const days = date::floor<chrono::days>(local());
 
         date::year_month_day const ymd{days};
         auto const year = static_cast<int>(ymd.year());
@@ -214,7 +242,7 @@ public:
         auto const day = static_cast<int>(static_cast<unsigned>(ymd.day()));
         Date const dt{year, month, day};
 
-        date::hh_mm_ss const hms{tp_.get_local_time() - days};
+        date::hh_mm_ss const hms{local() - days};
         auto hour = static_cast<int>(hms.hours().count());
         auto min = static_cast<int>(hms.minutes().count());
         auto sec = static_cast<int>(hms.seconds().count());
@@ -229,8 +257,8 @@ public:
     [[nodiscard]] DateTime
     add_days(int const n) const noexcept {
         namespace chrono = std::chrono;
-        auto const days = date::floor<chrono::days>(tp_.get_local_time());
-        date::hh_mm_ss const hms{tp_.get_local_time() - days};
+        auto const days = date::floor<chrono::days>(local());
+        date::hh_mm_ss const hms{local() - days};
         auto const added = days + chrono::days(n);
         auto const secs = chrono::floor<chrono::seconds>(added)
                           + hms.hours()
@@ -250,7 +278,7 @@ public:
     [[nodiscard]] int
     week_day() const noexcept {
         namespace chrono = std::chrono;
-        auto const wd = date::weekday(chrono::floor<chrono::days>(tp_.get_local_time()));
+        auto const wd = date::weekday(chrono::floor<chrono::days>(local()));
         return int(wd.iso_encoding());
     }
     [[nodiscard]] std::pair<DateTime, DateTime>
@@ -263,11 +291,145 @@ public:
     /// \return string z datą-czasem.
     [[nodiscard]] std::string
     str() const noexcept {
-        std::stringstream ss{};
-        ss << tp_.get_local_time();
-        return ss.str();
+        std::string text(TextSize, '\0');
+        format(local(), text.data());
+        return text;
+    }
+
+    /// Odczyt tekstu w formacie "%F %T" (np. 2023-10-23 11:06:21) - bez strumieni.
+    /// \return czas lokalny lub nic, jeśli tekst jest niepoprawny.
+    [[nodiscard]] static std::optional<date::local_seconds>
+    parse(std::string_view const text) noexcept {
+        if (text.size() != TextSize or text[4] != '-' or text[7] != '-' or text[10] != ' ' or text[13] != ':' or text[16] != ':')
+            return {};
+
+        bool ok = true;
+        auto number = [text, &ok](std::size_t const pos, std::size_t const n) {
+            int value{};
+            for (auto i = pos; i < pos + n; ++i) {
+                auto const c = text[i];
+                ok = ok and c >= '0' and c <= '9';
+                value = value * 10 + (c - '0');
+            }
+            return value;
+        };
+        auto const y = number(0, 4), m = number(5, 2), d = number(8, 2);
+        auto const hour = number(11, 2), min = number(14, 2), sec = number(17, 2);
+        if (not ok or hour > 23 or min > 59 or sec > 59)
+            return {};
+
+        date::year_month_day const ymd{date::year{y}, date::month(unsigned(m)), date::day(unsigned(d))};
+        if (not ymd.ok())
+            return {};
+        namespace chrono = std::chrono;
+        return date::local_days{ymd} + chrono::hours(hour) + chrono::minutes(min) + chrono::seconds(sec);
+    }
+
+    /// Zapis czasu lokalnego w formacie "%F %T" - dokładnie 'TextSize' znaków (lata 0-9999).
+    /// \return wskaźnik za ostatnim zapisanym znakiem.
+    static char*
+    format(date::local_seconds const tp, char* out) noexcept {
+        auto const days = date::floor<date::days>(tp);
+        date::year_month_day const ymd{days};
+        date::hh_mm_ss const hms{tp - days};
+
+        auto put = [&out](unsigned value, int const n, char const separator) {
+            for (int i = n - 1; i >= 0; --i, value /= 10)
+                out[i] = char('0' + value % 10);
+            out += n;
+            if (separator)
+                *out++ = separator;
+        };
+        put(unsigned(int(ymd.year())), 4, '-');
+        put(unsigned(ymd.month()), 2, '-');
+        put(unsigned(ymd.day()), 2, ' ');
+        put(unsigned(hms.hours().count()), 2, ':');
+        put(unsigned(hms.minutes().count()), 2, ':');
+        put(unsigned(hms.seconds().count()), 2, '\0');
+        return out;
     }
+
+    /// Data-czasy z wielu tekstów naraz (np. kolumna 'created' notatek).
+    /// Strefa jest ustalana raz, a przesunięcie względem UTC jest wyszukiwane
+    /// tylko przy zmianie okresu (czas letni/zimowy).
+    /// \param texts - teksty w formacie "%F %T" (cokolwiek, co daje std::string_view),
+    /// \return data-czasy (nic dla niepoprawnych tekstów).
+    template<std::ranges::input_range R>
+    [[nodiscard]] static std::vector<std::optional<DateTime>>
+    from_strings(R const& texts) {
+        auto const zone = default_zone();
+        std::vector<std::optional<DateTime>> data{};
+        if constexpr (std::ranges::sized_range<R>)
+            data.reserve(std::ranges::size(texts));
+        for (auto const& text : texts) {
+            if (auto const tp = parse(std::string_view{text}); tp)
+                data.emplace_back(DateTime(zone, to_sys(zone, *tp)));
+            else
+                data.emplace_back();
+        }
+        return data;
+    }
+
+    /// Teksty (LOCAL) wielu data-czasów naraz.
+    template<std::ranges::input_range R>
+    [[nodiscard]] static std::vector<std::string>
+    to_strings(R const& items) {
+        std::vector<std::string> data{};
+        if constexpr (std::ranges::sized_range<R>)
+            data.reserve(std::ranges::size(items));
+        for (DateTime const& item : items)
+            data.push_back(item.str());
+        return data;
+    }
+
 private:
+    /// Okres strefy ze stałym przesunięciem względem UTC, użyty ostatnio w tym
+    /// wątku - kolejne konwersje z tego samego okresu nie przeszukują bazy stref.
+    struct Period {
+        date::time_zone const* zone{};
+        date::sys_seconds begin{};
+        date::sys_seconds end{};
+        std::chrono::seconds offset{};
+    };
+    static Period& period() noexcept {
+        thread_local Period value{};
+        return value;
+    }
+    static void remember(date::time_zone const* const zone, date::sys_seconds const tp) {
+        auto const info = zone->get_info(tp);
+        period() = {zone, info.begin, info.end, info.offset};
+    }
+    static date::sys_seconds
+    to_sys(date::time_zone const* const zone, date::local_seconds const tp) {
+        auto const& p = period();
+        if (p.zone == zone) {
+            date::sys_seconds const sys{tp.time_since_epoch() - p.offset};
+            // Doba marginesu - czasy niejednoznaczne lub nieistniejące
+            // (przy zmianie czasu) wyznacza strefa.
+            if (sys >= p.begin + date::days{1} and sys < p.end - date::days{1})
+                return sys;
+        }
+        auto const sys = zone->to_sys(tp, date::choose::earliest);
+        remember(zone, sys);
+        return sys;
+    }
+    static date::local_seconds
+    to_local(date::time_zone const* const zone, date::sys_seconds const tp) {
+        if (auto const& p = period(); p.zone != zone or tp < p.begin or tp >= p.end)
+            remember(zone, tp);
+        return date::local_seconds{tp.time_since_epoch() + period().offset};
+    }
+
+    DateTime(date::time_zone const* const zone, date::sys_seconds const tp)
+            : zone{zone}, tp_{zone, tp}
+    {}
+
+    /// Czas lokalny (z zapamiętanego okresu strefy).
+    [[nodiscard]] date::local_seconds
+    local() const {
+        return to_local(tp_.get_time_zone(), tp_.get_sys_time());
+    }
+
     [[nodiscard]] zoned_time_t
     from_components(Date const dt, Time const tm) noexcept {
         namespace chrono = std::chrono;
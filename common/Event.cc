@@ -0,0 +1,75 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "Event.hh"
+#include <new>
+
+/// Pool of memory blocks for events (all events have the same size). \n
+/// Every thread has its own pool, so allocating and deleting events never
+/// takes a lock shared with other threads. Events are usually created in
+/// one thread and deleted in the thread of the receiver (GUI) - the blocks
+/// are then reused by the events that thread creates, the other threads
+/// allocate from the heap when their pool is empty.
+namespace {
+    struct EventPool {
+        static constexpr std::size_t Capacity = 256;
+        // Trivially destructible - valid also while the thread (program) exits,
+        // when Qt deletes the remaining events. Blocks left in the pool of
+        // an exiting thread are not returned to the heap.
+        void* blocks[Capacity];
+        std::size_t size;
+    };
+    thread_local constinit EventPool pool{};
+}
+
+void* Event::
+operator new(std::size_t const size) {
+    if (size == sizeof(Event) and pool.size > 0)
+        return pool.blocks[--pool.size];
+    return ::operator new(size);
+}
+
+void Event::
+operator delete(void* const ptr, std::size_t const size) noexcept {
+    if (ptr == nullptr)
+        return;
+    if (size == sizeof(Event) and pool.size < EventPool::Capacity) {
+        pool.blocks[pool.size++] = ptr;
+        return;
+    }
+    ::operator delete(ptr);
+}
+
+char const* event::
+name(int const id) noexcept {
+    switch (id) {
+        case CategorySelected: return "CategorySelected";
+        case CategoryAndNoteToSelect: return "CategoryAndNoteToSelect";
+        case NewNoteRequest: return "NewNoteRequest";
+        case EditNoteRequest: return "EditNoteRequest";
+        case RemoveCurrentNoteRequest: return "RemoveCurrentNoteRequest";
+        case MoveCurrentNoteRequest: return "MoveCurrentNoteRequest";
+        case SelectFontRequest: return "SelectFontRequest";
+        case BoldRequest: return "BoldRequest";
+        case ItalicRequest: return "ItalicRequest";
+        case Underline: return "Underline";
+        case SelectColorRequest: return "SelectColorRequest";
+        case CopyRequest: return "CopyRequest";
+        case CutRequest: return "CutRequest";
+        case PasteRequest: return "PasteRequest";
+        case UndoRequest: return "UndoRequest";
+        case RedoRequest: return "RedoRequest";
+        case SelectAllRequest: return "SelectAllRequest";
+        case NoteDatabaseChanged: return "NoteDatabaseChanged";
+        case NoteSelected: return "NoteSelected";
+        case SearchRequest: return "SearchRequest";
+        case CategoriesChanged: return "CategoriesChanged";
+        case NotesListingLoaded: return "NotesListingLoaded";
+        case SearchResultsLoaded: return "SearchResultsLoaded";
+        case NoteContentLoaded: return "NoteContentLoaded";
+        default: return "unknown";
+    }
+}
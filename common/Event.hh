@@ -28,17 +28,67 @@
 #include <QEvent>
 #include <QVector>
 #include <QVariant>
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <fmt/core.h>
 
+/*------- payloads of typed events:
+-------------------------------------------------------------------*/
+namespace event {
+    /// Payload type of the typed event (specialized below, after the event IDs).
+    template<int Id> struct Payload;
+}
+
 /*------- class:
 -------------------------------------------------------------------*/
+/// Event of the program. \n
+/// Arguments are either boxed in QVariant's (data) or - for typed events -
+/// are one payload shared by all receivers of the event (payload<Id>). \n
+/// Events are allocated from a per-thread pool (Qt deletes them after delivery).
+/// All events of the program are of this class, so receivers use static_cast.
 class Event : public QEvent {
     QVector<QVariant> data_{};
+    std::shared_ptr<void const> payload_{};
+    quint64 sequence_{};   // order of events of one type (coalescing)
+    std::chrono::steady_clock::time_point sent_{std::chrono::steady_clock::now()};
+    struct Typed {};
 public:
     template<typename... T>
     explicit Event(int const id, T... args) : QEvent(static_cast<QEvent::Type>(id)) {
         (..., data_.push_back(args));
     }
+    Event(Typed, int const id, std::shared_ptr<void const> payload) noexcept :
+            QEvent(static_cast<QEvent::Type>(id)),
+            payload_{std::move(payload)}
+    {}
+
+    /// Typed event - the payload is shared (not copied) by all receivers.
+    template<int Id>
+    static Event* typed(std::shared_ptr<event::Payload<Id> const> payload) noexcept {
+        return new Event(Typed{}, Id, std::move(payload));
+    }
+    /// Payload of the typed event (the ID of the event must be 'Id').
+    template<int Id>
+    [[nodiscard]] event::Payload<Id> const& payload() const noexcept {
+        Q_ASSERT(int(type()) == Id and payload_);
+        return *static_cast<event::Payload<Id> const*>(payload_.get());
+    }
+
+    [[nodiscard]] quint64 sequence() const noexcept {
+        return sequence_;
+    }
+    void sequence(quint64 const value) noexcept {
+        sequence_ = value;
+    }
+
+    /// Time of sending (the event was posted to the queue).
+    [[nodiscard]] std::chrono::steady_clock::time_point sent() const noexcept {
+        return sent_;
+    }
+
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size) noexcept;
 
     QVector<QVariant> data() && {
         fmt::print("events data moved\n");
@@ -74,5 +124,32 @@ namespace event {
         SelectAllRequest,
         NoteDatabaseChanged,
         NoteSelected,
+        SearchRequest,
+        CategoriesChanged,
+        // Wyniki zleceń wątku bazy danych (ticket, wynik).
+        NotesListingLoaded,
+        SearchResultsLoaded,
+        NoteContentLoaded,
+    };
+    /// Number of the program's events (CategorySelected ... NoteContentLoaded).
+    constexpr int Count = NoteContentLoaded - CategorySelected + 1;
+    /// Is it an event of the program (not another QEvent of the user range)?
+    constexpr bool known(int const id) noexcept {
+        return id >= CategorySelected and id <= NoteContentLoaded;
+    }
+
+    /// Name of the event (diagnostics).
+    char const* name(int id) noexcept;
+}
+
+/*------- payloads of typed events:
+-------------------------------------------------------------------*/
+namespace event {
+    template<> struct Payload<CategorySelected> {
+        qint64 categoryID{};
+        qint64 noteID{-1};      // note to select (-1 - the first one)
+    };
+    template<> struct Payload<NoteSelected> {
+        qint64 noteID{};
     };
 }
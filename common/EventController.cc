@@ -3,6 +3,190 @@
 //
 
 #include "EventController.hh"
+#include "EventStats.hh"
+#include <QMetaObject>
+#include <QTimer>
+#include <thread>
 
-EventController::EventController() : QObject() {}
+EventController::EventController() :
+        QObject(),
+        snapshot_{std::make_shared<Subscriptions const>()}
+{}
 
+void EventController::
+policy(int const id, EventPolicy const policy) noexcept {
+    if (not event::known(id))
+        return;
+
+    auto const coalesced = policy.coalescing != Coalescing::None;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (not coalesced) {
+            if (auto const it = slots_.find(id); it != slots_.end()) {
+                delete it->timer;
+                slots_.erase(it);
+            }
+        }
+        else {
+            auto& slot = slots_[id];
+            slot.policy = policy;
+            if (not slot.timer and (policy.coalescing == Coalescing::Debounce or policy.coalescing == Coalescing::Throttle)) {
+                slot.timer = new QTimer(this);
+                slot.timer->setSingleShot(true);
+                connect(slot.timer, &QTimer::timeout, this, [this, id] { timeout(id); });
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(writer_);
+    update([id, coalesced](Subscriptions& s) {
+        if (coalesced) s.coalesced.insert(id);
+        else s.coalesced.remove(id);
+    });
+}
+
+void EventController::
+subscribe(QObject* const subscriber, std::initializer_list<int> const ids) noexcept {
+    std::lock_guard<std::mutex> lock(writer_);
+
+    auto& own = subscribed_[subscriber];
+    update([&](Subscriptions& s) {
+        for (auto const id : ids)
+            if (not own.contains(id)) {
+                own << id;
+                s.receivers[id] << subscriber;
+            }
+    });
+    // Filter drops superseded events before they reach the subscriber.
+    subscriber->installEventFilter(this);
+}
+
+void EventController::
+remove(QObject* const subscriber) noexcept {
+    std::lock_guard<std::mutex> lock(writer_);
+
+    auto const ids = subscribed_.take(subscriber);
+    if (ids.isEmpty())
+        return;
+
+    update([&](Subscriptions& s) {
+        for (auto const id : ids)
+            if (auto const it = s.receivers.find(id); it != s.receivers.end()) {
+                it->removeOne(subscriber);
+                if (it->isEmpty())
+                    s.receivers.erase(it);
+            }
+    });
+    subscriber->removeEventFilter(this);
+
+    // Wątki, które jeszcze wysyłają zdarzenia wg starszych migawek,
+    // kończą w ciągu mikrosekund - czeka tylko usuwający (nigdy wysyłający).
+    for (auto const& snapshot : retired_)
+        while (not snapshot.expired())
+            std::this_thread::yield();
+    retired_.clear();
+}
+
+/// Nowa migawka jest kopią bieżącej - QHash i QList dzielą dane niejawnie,
+/// więc kopiowane są tylko listy zmienianych zdarzeń.
+void EventController::
+update(std::function<void(Subscriptions&)> const& fn) noexcept {
+    auto next = std::make_shared<Subscriptions>(*snapshot_.load(std::memory_order_acquire));
+    fn(*next);
+    auto const previous = snapshot_.exchange(std::move(next), std::memory_order_acq_rel);
+
+    // Zastąpione migawki, których nikt już nie czyta, nie są pamiętane.
+    std::erase_if(retired_, [](auto const& snapshot) { return snapshot.expired(); });
+    retired_.emplace_back(previous);
+}
+
+/// Zdarzenie jest wysyłane (lub odkładane) zgodnie z polityką jego typu.
+/// Każde zdarzenie dostaje kolejny numer - starsze, jeszcze w kolejce, są odrzucane.
+void EventController::
+coalesce(int const id, std::function<Event*()> make) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto& slot = slots_[id];
+    auto const sequence = latest(id).fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    switch (slot.policy.coalescing) {
+        case Coalescing::None:
+        case Coalescing::LatestWins:
+            post(id, make, sequence);
+            break;
+        case Coalescing::Debounce:
+            // Każde nowe zdarzenie odsuwa wysłanie o pełne okno.
+            slot.pending = [this, id, make = std::move(make), sequence] { post(id, make, sequence); };
+            start(slot.timer, slot.policy.window);
+            break;
+        case Coalescing::Throttle: {
+            auto const now = Clock::now();
+            auto const due = slot.last + slot.policy.window;
+            if (not slot.pending and now >= due) {
+                slot.last = now;
+                post(id, make, sequence);
+                break;
+            }
+            // Najnowsze zdarzenie zostanie wysłane na końcu okna
+            // (timer już odlicza, jeśli jakieś zdarzenie czeka).
+            auto const waiting = bool(slot.pending);
+            slot.pending = [this, id, make = std::move(make), sequence] { post(id, make, sequence); };
+            if (not waiting)
+                start(slot.timer, std::chrono::ceil<std::chrono::milliseconds>(due - now));
+            break;
+        }
+    }
+}
+
+void EventController::
+post(int const id, std::function<Event*()> const& make, quint64 const sequence) noexcept {
+    auto const snapshot = snapshot_.load(std::memory_order_acquire);
+    if (auto const it = snapshot->receivers.constFind(id); it != snapshot->receivers.constEnd())
+        for (auto const& receiver : *it) {
+            auto const event = make();
+            event->sequence(sequence);
+            QApplication::postEvent(receiver, event);
+        }
+}
+
+/// Timer należy do wątku kontrolera - zdarzenia mogą być wysyłane z innych wątków.
+void EventController::
+start(QTimer* const timer, std::chrono::milliseconds const interval) noexcept {
+    QMetaObject::invokeMethod(timer, [timer, interval] { timer->start(interval); });
+}
+
+void EventController::
+timeout(int const id) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (auto const it = slots_.find(id); it != slots_.end() and it->pending) {
+        auto const pending = std::move(it->pending);
+        it->pending = nullptr;
+        it->last = Clock::now();
+        pending();
+    }
+}
+
+/// Odrzucenie zdarzeń, które w kolejce zostały zastąpione nowszymi. \n
+/// Przy włączonych statystykach zdarzenie jest dostarczane tutaj - mierzony
+/// jest czas w kolejce i czas obsługi przez odbiorcę (customEvent).
+bool EventController::
+eventFilter(QObject* const watched, QEvent* const event) {
+    // Tylko zdarzenia programu - inne zdarzenia z zakresu User to nie 'Event'.
+    auto const id = int(event->type());
+    if (not event::known(id))
+        return QObject::eventFilter(watched, event);
+
+    if (snapshot_.load(std::memory_order_acquire)->coalesced.contains(id))
+        if (static_cast<Event*>(event)->sequence() < latest(id).load(std::memory_order_acquire))
+            return true;
+
+    if (auto& stats = EventStats::instance(); stats.enabled()) {
+        auto const start = EventStats::Clock::now();
+        watched->event(event);
+        stats.record(id, start - static_cast<Event*>(event)->sent(), EventStats::Clock::now() - start);
+        return true;
+    }
+    return QObject::eventFilter(watched, event);
+}
@@ -30,12 +30,70 @@
 #include <QSet>
 #include <QList>
 #include <QApplication>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
+/*------- forward declarations:
+-------------------------------------------------------------------*/
+class QTimer;
+
+/*------- types:
+-------------------------------------------------------------------*/
+/// How events of one type are coalesced before delivery.
+enum class Coalescing {
+    None,       // every event is delivered
+    LatestWins, // a new event supersedes events still queued
+    Debounce,   // delivered when no new event was sent for 'window'
+    Throttle,   // at most one event per 'window' (the latest one is delivered at the end)
+};
+
+struct EventPolicy {
+    Coalescing coalescing{Coalescing::None};
+    std::chrono::milliseconds window{};
+};
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Subscribers are kept in an immutable snapshot which is swapped atomically
+/// on every subscription change (copy-on-write). Sending an event without
+/// a coalescing policy only loads the current snapshot, so worker threads
+/// publishing results do not wait for subscription changes or for the GUI
+/// thread delivering events. (std::atomic<std::shared_ptr> is not lock-free
+/// in libstdc++ - its internal lock is held only for the copy of the pointer.)
+/// Events come from a per-thread pool. \n
+/// Sending an event with a policy takes the mutex of coalescing slots
+/// (timers and the event waiting for them) - senders of such events contend
+/// with each other and with the timers, never with delivery: the filter
+/// drops superseded events by comparing sequence numbers with an atomic.
 class EventController : public QObject {
-    using EventStore = QHash<int, QSet<QObject*>>;
-    std::mutex mutex_;
-    EventStore store_{};
+    using Clock = std::chrono::steady_clock;
+    /// Immutable snapshot of subscriptions.
+    struct Subscriptions {
+        QHash<int, QList<QObject*>> receivers{};    // event ID -> subscribers
+        QSet<int> coalesced{};                      // event IDs with a policy
+    };
+    using Snapshot = std::shared_ptr<Subscriptions const>;
+    /// State of the event type with a coalescing policy.
+    struct Slot {
+        EventPolicy policy{};
+        QTimer* timer{};                    // debounce/throttle
+        std::function<void()> pending{};    // event waiting for the timer
+        Clock::time_point last{};           // last delivery (throttle)
+    };
+    std::atomic<Snapshot> snapshot_;
+    std::mutex writer_;                         // append/remove/policy (writers only)
+    QHash<QObject*, QList<int>> subscribed_{};  // subscriber -> event IDs (under 'writer_')
+    std::vector<std::weak_ptr<Subscriptions const>> retired_{};  // replaced, maybe still read
+    std::mutex mutex_;                          // coalescing slots
+    QHash<int, Slot> slots_{};
+    // Sequence number of the latest coalesced event of each type (read by the filter without locking).
+    std::array<std::atomic<quint64>, event::Count> latest_{};
 public:
     static EventController& instance() noexcept {
         static EventController controller;
@@ -49,47 +107,79 @@ public:
     EventController& operator=(EventController&&) = delete;
     ~EventController() override = default;
 
+    /// Coalescing policy of events with the given ID (set in the GUI thread,
+    /// before the events are sent). Superseded events still waiting in
+    /// the queue are dropped before delivery. \n
+    /// Only events of the program (event::known) can have a policy.
+    void policy(int id, EventPolicy policy) noexcept;
+
     /// Add a subscriber that is interested in receiving events with the given IDs
     /// \param subscriber - subscriber to append,
     /// \param ids - event IDs.
     template<typename... T> void append(QObject* subscriber, T... ids) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        auto add = [&](QObject* const s, int const id) {
-            auto const exists = store_.contains(id) and store_.value(id).contains(subscriber);
-            if (not exists)
-                store_[id] << s;
-        };
-
-        // iterate over ids
-        (..., add(subscriber, ids));
+        subscribe(subscriber, {int(ids)...});
     }
 
-    /// The specified subscriber no longer wants to follow the events.
+    /// The specified subscriber no longer wants to follow the events. \n
+    /// Only the subscriber's own event IDs are visited. When the function
+    /// returns, no thread is posting events to the subscriber anymore
+    /// (it can be safely deleted).
     /// \param subscriber - subscriber to remove.
-    void remove(QObject* const subscriber) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        auto const ids = store_.keys();
-        for (int id : ids)
-            store_[id].remove(subscriber);
-        store_.squeeze();
-    }
+    void remove(QObject* subscriber) noexcept;
 
     /// Dispatch of an event with the given ID and the given arguments.
     /// \param id - events ID,
     /// \param args - arguments of the event.
     template<typename... T>
     void send(int const id, T... args) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto const snapshot = snapshot_.load(std::memory_order_acquire);
 
-        if (store_.contains(id)) {
-            auto const& subsribers = store_[id];
-            for (auto const& receiver : subsribers)
+        if (snapshot->coalesced.contains(id))
+            coalesce(id, [id, args...] { return new Event(id, args...); });
+        else if (auto const it = snapshot->receivers.constFind(id); it != snapshot->receivers.constEnd())
+            for (auto const& receiver : *it)
                 QApplication::postEvent(receiver, new Event(id, args...));
-        }
+    }
+
+    /// Dispatch of a typed event - the payload is created once and shared
+    /// by all subscribers (no QVariant boxing, no copies per subscriber).
+    /// \param args - fields of the payload 'event::Payload<Id>'.
+    template<int Id, typename... T>
+    void publish(T&&... args) noexcept {
+        using Payload = event::Payload<Id>;
+        auto const snapshot = snapshot_.load(std::memory_order_acquire);
+
+        // Coalesced events find their subscribers when they are delivered.
+        auto const coalesced = snapshot->coalesced.contains(Id);
+        auto const it = snapshot->receivers.constFind(Id);
+        if (not coalesced and it == snapshot->receivers.constEnd())
+            return;
+
+        auto const payload = std::make_shared<Payload const>(Payload{std::forward<T>(args)...});
+        if (coalesced)
+            coalesce(Id, [payload] { return Event::typed<Id>(payload); });
+        else
+            for (auto const& receiver : *it)
+                QApplication::postEvent(receiver, Event::typed<Id>(payload));
     }
 
 private:
     EventController();
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+    void subscribe(QObject* subscriber, std::initializer_list<int> ids) noexcept;
+    /// Copy of the current snapshot, changed by 'fn' and published.
+    /// \remark Called with 'writer_' locked.
+    void update(std::function<void(Subscriptions&)> const& fn) noexcept;
+    [[nodiscard]] std::atomic<quint64>& latest(int const id) noexcept {
+        return latest_[std::size_t(id - event::CategorySelected)];
+    }
+
+    /// Dispatch according to the policy of the event type.
+    void coalesce(int id, std::function<Event*()> make) noexcept;
+    /// Post the event to all subscribers (with the sequence number).
+    void post(int id, std::function<Event*()> const& make, quint64 sequence) noexcept;
+    /// Start the timer of the slot (in the thread of the controller).
+    void start(QTimer* timer, std::chrono::milliseconds interval) noexcept;
+    void timeout(int id) noexcept;
 };
@@ -0,0 +1,88 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "EventStats.hh"
+#include "Event.hh"
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <fmt/core.h>
+
+/*------- local functions:
+-------------------------------------------------------------------*/
+/// Indeks kubełka: 0 - poniżej 1 µs, n - poniżej 2^n µs.
+static std::size_t
+bucketOf(EventStats::Clock::duration const value) noexcept {
+    auto const us = std::chrono::duration_cast<std::chrono::microseconds>(value).count();
+    if (us <= 0)
+        return 0;
+    return std::min<std::size_t>(std::bit_width(u64(us)), EventStats::Buckets - 1);
+}
+
+static double
+ms(EventStats::Clock::duration const value) noexcept {
+    return std::chrono::duration<double, std::milli>(value).count();
+}
+
+void EventStats::Histogram::
+add(Clock::duration const value) noexcept {
+    ++buckets[bucketOf(value)];
+    ++count;
+    sum += value;
+    max = std::max(max, value);
+}
+
+/// Percentyl jest szacowany górną granicą kubełka (nie większą niż maksimum).
+EventStats::Clock::duration EventStats::Histogram::
+percentile(double const p) const noexcept {
+    auto const wanted = std::max<u64>(1, u64(p * double(count) + 0.5));
+    u64 seen{};
+    for (std::size_t i = 0; i < Buckets; ++i)
+        if ((seen += buckets[i]) >= wanted)
+            return std::min<Clock::duration>(std::chrono::microseconds(u64(1) << i), max);
+    return max;
+}
+
+void EventStats::
+record(int const id, Clock::duration const queue, Clock::duration const handler) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& series = series_[id];
+    series.queue.add(queue);
+    series.handler.add(handler);
+}
+
+void EventStats::
+reset() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    series_.clear();
+}
+
+void EventStats::
+dump(std::FILE* const out) const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Zdarzenia w kolejności ich numerów.
+    std::map<int, Series const*> const sorted = [this] {
+        std::map<int, Series const*> data{};
+        for (auto const& [id, series] : series_)
+            data[id] = &series;
+        return data;
+    }();
+
+    auto line = [out](std::string_view name, Histogram const& h) {
+        fmt::print(out, "  {:<8} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}\n", name,
+                   ms(h.sum) / double(std::max<u64>(h.count, 1)),
+                   ms(h.percentile(.5)), ms(h.percentile(.9)), ms(h.percentile(.99)), ms(h.max));
+    };
+
+    fmt::print(out, "{:<10} {:>9} {:>9} {:>9} {:>9} {:>9}\n", "(ms)", "avg", "p50", "p90", "p99", "max");
+    for (auto const& [id, series] : sorted) {
+        fmt::print(out, "{} ({}): {} events\n", event::name(id), id, series->queue.count);
+        line("queue", series->queue);
+        line("handler", series->handler);
+    }
+    std::fflush(out);
+}
@@ -0,0 +1,80 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared.hh"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Latency of the event path, aggregated per event type. \n
+/// For every delivered event two durations are recorded: the queue delay
+/// (from sending the event to the start of its delivery) and the duration
+/// of the receiver's handler. Each is kept in a histogram with logarithmic
+/// buckets (1 µs, 2 µs, 4 µs, ...), so recording costs no allocation. \n
+/// Disabled by default - enabled with the command line flag '--event-stats';
+/// the histograms are written at exit or on demand (dump).
+class EventStats {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t Buckets = 32;     // up to ~35 minutes
+
+    static EventStats& instance() noexcept {
+        static EventStats stats;
+        return stats;
+    }
+
+    // no copy, no move
+    EventStats(EventStats const&) = delete;
+    EventStats& operator=(EventStats const&) = delete;
+    EventStats(EventStats&&) = delete;
+    EventStats& operator=(EventStats&&) = delete;
+
+    [[nodiscard]] bool enabled() const noexcept {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    void enable(bool const state = true) noexcept {
+        enabled_.store(state, std::memory_order_relaxed);
+    }
+
+    /// Record one delivered event.
+    /// \param id - event ID,
+    /// \param queue - time spent in the queue,
+    /// \param handler - duration of the handler.
+    void record(int id, Clock::duration queue, Clock::duration handler) noexcept;
+
+    /// Write the histograms of all event types (percentiles and maximum).
+    void dump(std::FILE* out = stderr) const noexcept;
+    /// Forget all recorded events.
+    void reset() noexcept;
+
+private:
+    EventStats() = default;
+
+    struct Histogram {
+        std::array<u64, Buckets> buckets{};
+        u64 count{};
+        Clock::duration sum{};
+        Clock::duration max{};
+
+        void add(Clock::duration value) noexcept;
+        /// Upper bound of the bucket with the given percentile (0..1).
+        [[nodiscard]] Clock::duration percentile(double p) const noexcept;
+    };
+    struct Series {
+        Histogram queue{};
+        Histogram handler{};
+    };
+
+    std::atomic<bool> enabled_{};
+    mutable std::mutex mutex_;
+    std::unordered_map<int, Series> series_{};
+};
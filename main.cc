@@ -27,17 +27,25 @@
 -------------------------------------------------------------------*/
 #include "model/category.hh"
 #include "model/note.hh"
+#include "model/NoteImporter.hh"
+#include "benchmark.hh"
 #include "sqlite/sqlite.hh"
+#include "common/DatabaseExecutor.hh"
+#include "common/EventController.hh"
+#include "common/Datime.hh"
+#include "common/EventStats.hh"
 #include "notes/MainWindow.hh"
 #include "notes/Settings.hh"
 #include "shared.hh"
 #include <QApplication>
 #include <QDir>
 #include <fmt/core.h>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <format>
 using namespace std;
+using namespace std::chrono_literals;
 
 bool create_cmds(SQLite const& db, std::vector<std::string> const& commands) noexcept {
     for (auto const& cmd : commands) {
@@ -47,6 +55,35 @@ bool create_cmds(SQLite const& db, std::vector<std::string> const& commands) noe
     return true;
 }
 
+/// Configuration of database connections (from the settings).
+void configure_database() noexcept {
+    Settings settings{};
+    SQLite::configure({
+        .wal = settings.read(settings::DATABASE_WAL_KEY)
+                .value_or(settings::DEFAULT_DATABASE_WAL).toBool(),
+        .busy_timeout = std::max(0, settings.read(settings::DATABASE_BUSY_TIMEOUT_KEY)
+                .value_or(settings::DEFAULT_DATABASE_BUSY_TIMEOUT).toInt())
+    });
+}
+
+/// Time zone of dates (from the settings, if present).
+void configure_time_zone() noexcept {
+    Settings settings{};
+    if (auto const zone = settings.read(settings::DATETIME_ZONE_KEY); zone) {
+        auto const name = zone->toString().toStdString();
+        if (not DateTime::set_default_zone(name))
+            cerr << fmt::format("Unknown time zone '{}', using {}.\n", name, DateTime::DefaultZone);
+    }
+}
+
+/// Number of read-only connections (threads) for the widgets.
+std::size_t database_readers() noexcept {
+    Settings settings{};
+    auto const n = settings.read(settings::DATABASE_READERS_KEY)
+            .value_or(settings::DEFAULT_DATABASE_READERS).toInt();
+    return std::size_t(std::clamp(n, 1, 16));
+}
+
 /// Open the database, if that fails create a new database.
 bool open_or_create_database() noexcept {
     auto const database_dir = shared::home_dir() + "/.beesoft";
@@ -56,30 +93,101 @@ bool open_or_create_database() noexcept {
     auto const database_path = database_dir + "/notes.sqlite";
 
     // Try to open.
-    if (SQLite::instance().open(database_path))
+    if (SQLite::instance().open(database_path)) {
+        // Without an up-to-date index only the search is incomplete - not a reason to stop.
+        if (not Note::createSearchIndexIfNeeded())
+            cerr << "Can't update the full-text search index, search results may be incomplete.\n";
         return true;
+    }
 
     // Can't open so create one.
     return SQLite::instance().create(database_path, [](SQLite const& db){
         // Create tables.
-        return create_cmds(db, Category::CreationCmd) and create_cmds(db, Note::CreationCmd);
+        return create_cmds(db, Category::CreationCmd) and create_cmds(db, Note::CreationCmd)
+            and create_cmds(db, Note::SearchCreationCmd);
     }, false);
 }
 
 
+/// Value of the command line option (e.g. '--category 12').
+std::optional<std::string> option(int const argc, char* argv[], std::string_view const name) noexcept {
+    for (int i = 1; i < argc - 1; ++i)
+        if (name == argv[i])
+            return argv[i + 1];
+    return {};
+}
+
+/// Is the command line flag present (e.g. '--bench-subtree')?
+bool flag(int const argc, char* argv[], std::string_view const name) noexcept {
+    for (int i = 1; i < argc; ++i)
+        if (name == argv[i])
+            return true;
+    return false;
+}
+
+/// Headless import of notes (without GUI):
+///     cnotes --import <directory|export.json> --category <id> [--batch <n>]
+int import_notes(int const argc, char* argv[]) noexcept {
+    auto const path = option(argc, argv, "--import");
+    auto const category = option(argc, argv, "--category");
+    if (not path or not category) {
+        cerr << "usage: cnotes --import <directory|export.json> --category <id> [--batch <n>]\n";
+        return 1;
+    }
+    auto const categoryID = shared::to_int(*category);
+    if (not categoryID or not Category::nameWithID(*categoryID)) {
+        cerr << fmt::format("There is no category with ID {}.\n", *category);
+        return 1;
+    }
+    auto batch = NoteImporter::DefaultBatchSize;
+    if (auto const value = option(argc, argv, "--batch"); value)
+        if (auto const n = shared::to_int(*value); n and *n > 0)
+            batch = std::size_t(*n);
+
+    NoteImporter importer{*categoryID, batch};
+    if (auto const stats = importer.run(*path); stats) {
+        cout << stats->str() << '\n';
+        return stats->failed ? 2 : 0;
+    }
+    return 1;
+}
+
 int main(int argc, char *argv[]) {
     QCoreApplication::setApplicationName(shared::PROGRAM);
     QCoreApplication::setApplicationVersion(settings::appVersion().c_str());
     QCoreApplication::setOrganizationName(shared::ORGANIZATION);
     QCoreApplication::setOrganizationDomain(shared::DOMAIN);
 
+    // Benchmarks use their own in-memory database.
+    if (flag(argc, argv, "--bench-subtree"))
+        return bench::subtree();
+    if (flag(argc, argv, "--bench-datetime"))
+        return bench::datetime();
+
+    configure_time_zone();
+    configure_database();
     if (not open_or_create_database()) {
         cout << format("Database could not be created. Exiting...\n");
         return 1;
     }
 
+    if (option(argc, argv, "--import"))
+        return import_notes(argc, argv);
+
     QApplication app(argc, argv);
+    // Latency of events per type (written at exit, or on demand with Ctrl+Shift+F12).
+    if (flag(argc, argv, "--event-stats"))
+        EventStats::instance().enable();
+    // Bursts of selection events (keyboard scrolling) are coalesced.
+    EventController::instance().policy(event::CategorySelected, {Coalescing::Debounce, 500ms});
+    EventController::instance().policy(event::NoteSelected, {Coalescing::Throttle, 100ms});
+    // Reads for the widgets run in separate threads (with their own read-only connections).
+    DatabaseExecutor::instance().start(SQLite::instance().path(), database_readers());
     MainWindow win;
     win.show();
-    return QApplication::exec();
+    auto const result = QApplication::exec();
+    DatabaseExecutor::instance().stop();
+    if (EventStats::instance().enabled())
+        EventStats::instance().dump();
+    return result;
 }
@@ -0,0 +1,114 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "CategoryIndex.hh"
+#include "StoreCategory.hh"
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+std::vector<i64> CategoryIndex::
+subtree(i64 const id) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (not build())
+        return {id};
+
+    std::vector<i64> ids{};
+    if (id == 0) {
+        ids.reserve(order_.size() + 1);
+        ids.push_back(0);
+        ids.insert(ids.end(), order_.begin(), order_.end());
+        return ids;
+    }
+    if (auto const it = nodes_.find(id); it != nodes_.end() and reachable(it->second)) {
+        auto const& node = it->second;
+        return {order_.begin() + node.first, order_.begin() + node.last};
+    }
+    return {id};
+}
+
+std::optional<std::vector<std::string>> CategoryIndex::
+namesChain(i64 const id) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (not build())
+        return {};
+
+    std::vector<std::string> names{};
+    auto it = nodes_.find(id);
+    // Łańcuch osiągalnej kategorii zawsze kończy się na kategorii głównej.
+    while (it != nodes_.end() and reachable(it->second)) {
+        names.push_back(it->second.name);
+        if (it->second.pid == 0) break;
+        it = nodes_.find(it->second.pid);
+    }
+    if (names.empty())
+        return {};
+
+    std::ranges::reverse(names);
+    return names;
+}
+
+/// Kategorie ze wspólnego magazynu (bez zapytań SQL) i wyznaczenie
+/// kolejności pre-order z przedziałami poddrzew.
+/// \remark Wywoływana przy zablokowanym 'mutex_'.
+bool CategoryIndex::
+build() noexcept {
+    auto const& store = StoreCategory::instance();
+    if (generation_ == store.generation())
+        return true;
+
+    nodes_.clear();
+    order_.clear();
+    nodes_.reserve(store.size());
+    order_.reserve(store.size());
+
+    std::unordered_map<i64, std::vector<i64>> children{};
+    store.forEach([&](Category const& category) {
+        nodes_.emplace(category.id(), Node{.pid = category.pid(), .name = category.name()});
+        children[category.pid()].push_back(category.id());
+    });
+    // Kolejność dzieci jak w bazie danych (wg ID) - wynik nie zależy od kolejności wierszy.
+    for (auto& [_, ids] : children)
+        std::ranges::sort(ids);
+
+    // Korzenie: kategorie główne oraz kategorie, których rodzica nie ma (osierocone).
+    std::vector<i64> roots{};
+    for (auto const& [id, node] : nodes_)
+        if (node.pid == 0 or not nodes_.contains(node.pid))
+            roots.push_back(id);
+    std::ranges::sort(roots);
+
+    // Przejście DFS bez rekurencji: (id, true) - wejście, (id, false) - wyjście z poddrzewa.
+    std::vector<std::pair<i64, bool>> stack{};
+    std::unordered_set<i64> visited{};
+    visited.reserve(nodes_.size());
+    auto const visit = [&](i64 const root) {
+        if (visited.insert(root).second)
+            stack.emplace_back(root, true);
+        while (not stack.empty()) {
+            auto const [id, enter] = stack.back();
+            stack.pop_back();
+            auto& node = nodes_[id];
+            if (not enter) {
+                node.last = u32(order_.size());
+                continue;
+            }
+            node.first = u32(order_.size());
+            order_.push_back(id);
+            stack.emplace_back(id, false);
+            if (auto const it = children.find(id); it != children.end())
+                for (auto child = it->second.rbegin(); child != it->second.rend(); ++child)
+                    // Już odwiedzone dziecko oznacza cykl w danych - pomijamy.
+                    if (visited.insert(*child).second)
+                        stack.emplace_back(*child, true);
+        }
+    };
+    for (auto const root : roots)
+        visit(root);
+
+    generation_ = store.generation();
+    return true;
+}
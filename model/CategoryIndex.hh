@@ -0,0 +1,63 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared.hh"
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// In-memory index of the category tree. \n
+/// Categories are taken from the shared StoreCategory and kept in pre-order: every category
+/// knows the interval [first, last) of its subtree in 'order_', so the IDs of
+/// the subtree are a slice of the vector and the chain of parents is a walk
+/// over 'pid' - no SQL queries. \n
+/// The index is built lazily and rebuilt when the generation of the store
+/// differs from the one the index was built from.
+class CategoryIndex {
+    struct Node {
+        i64 pid{};
+        std::string name{};
+        u32 first{};    // position of the category in 'order_'
+        u32 last{};     // position after the last category of the subtree
+    };
+
+    mutable std::mutex mutex_;
+    u64 generation_{};
+    std::unordered_map<i64, Node> nodes_{};
+    std::vector<i64> order_{};
+public:
+    static CategoryIndex& instance() noexcept {
+        static CategoryIndex index;
+        return index;
+    }
+
+    // no copy, no move
+    CategoryIndex(CategoryIndex const&) = delete;
+    CategoryIndex& operator=(CategoryIndex const&) = delete;
+    CategoryIndex(CategoryIndex&&) = delete;
+    CategoryIndex& operator=(CategoryIndex&&) = delete;
+
+    /// IDs of the category and all its subcategories (in pre-order). \n
+    /// For 0 (root) - IDs of all categories.
+    std::vector<i64> subtree(i64 id) noexcept;
+
+    /// Names of categories from the main category to the category with given ID.
+    std::optional<std::vector<std::string>> namesChain(i64 id) noexcept;
+
+private:
+    CategoryIndex() = default;
+    bool build() noexcept;
+
+    /// Categories in a cycle (broken data) are not reachable from any main category.
+    static bool reachable(Node const& node) noexcept {
+        return node.last > node.first;
+    }
+};
@@ -0,0 +1,248 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "NoteImporter.hh"
+#include "note.hh"
+#include "../sqlite/sqlite.hh"
+#include <glaze/glaze.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <fmt/core.h>
+
+/*------- local constants:
+-------------------------------------------------------------------*/
+// Notes which already exist (unique pid, title, description) are skipped.
+static std::string const InsertQuery{"INSERT OR IGNORE INTO note (pid, title, description, content) VALUES (?,?,?,?)"};
+
+/*------- local functions:
+-------------------------------------------------------------------*/
+/// Read the whole file.
+static std::optional<std::string>
+readFile(fs::path const& path) noexcept {
+    std::ifstream in{path, std::ios::binary};
+    if (not in)
+        return {};
+    std::stringstream buffer{};
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+static std::string
+htmlEscaped(std::string_view text) noexcept {
+    std::string buffer{};
+    buffer.reserve(text.size());
+    for (auto const c : text) {
+        switch (c) {
+            case '&': buffer += "&amp;"; break;
+            case '<': buffer += "&lt;"; break;
+            case '>': buffer += "&gt;"; break;
+            case '"': buffer += "&quot;"; break;
+            default: buffer += c;
+        }
+    }
+    return buffer;
+}
+
+/// Conversion of plain text (and simple Markdown) to HTML. \n
+/// Paragraphs are separated with empty lines, Markdown headings (#) become <h1>..<h6>.
+static std::string
+textToHtml(std::string_view text, bool const markdown) noexcept {
+    std::string html{"<html><body>"};
+    bool inParagraph = false;
+
+    auto closeParagraph = [&] {
+        if (inParagraph) html += "</p>";
+        inParagraph = false;
+    };
+
+    while (not text.empty()) {
+        auto const pos = text.find('\n');
+        auto line = text.substr(0, pos);
+        text.remove_prefix(pos == std::string_view::npos ? text.size() : pos + 1);
+        if (not line.empty() and line.back() == '\r')
+            line.remove_suffix(1);
+
+        if (shared::trim(std::string{line}).empty()) {
+            closeParagraph();
+            continue;
+        }
+        if (markdown and line.starts_with('#')) {
+            auto const n = std::min(line.find_first_not_of('#'), line.size());
+            closeParagraph();
+            html += fmt::format("<h{0}>{1}</h{0}>", std::min<std::size_t>(n, 6), htmlEscaped(shared::trim(std::string{line.substr(n)})));
+            continue;
+        }
+        html += inParagraph ? "<br>" : "<p>";
+        html += htmlEscaped(line);
+        inParagraph = true;
+    }
+    closeParagraph();
+    html += "</body></html>";
+    return html;
+}
+
+NoteImporter::NoteImporter(i64 const categoryID, std::size_t const batchSize) noexcept :
+        categoryID_{categoryID},
+        batchSize_{std::max<std::size_t>(batchSize, 1)}
+{}
+
+std::optional<NoteImporter::Stats> NoteImporter::
+run(fs::path const& path) noexcept {
+    stats_ = {};
+    inBatch_ = 0;
+    auto const start = std::chrono::steady_clock::now();
+
+    std::error_code ec{};
+    auto const ok = fs::is_directory(path, ec) ? importDirectory(path) : importJson(path);
+    // The last (incomplete) batch.
+    if (inBatch_ > 0 and not commit())
+        return {};
+    if (not ok)
+        return {};
+
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats_;
+}
+
+/// Each regular file with known extension is one note.
+bool NoteImporter::
+importDirectory(fs::path const& dir) noexcept {
+    std::error_code ec{};
+    std::vector<fs::path> files{};
+    for (auto it = fs::directory_iterator{dir, ec}; not ec and it != fs::directory_iterator{}; it.increment(ec))
+        if (it->is_regular_file())
+            files.push_back(it->path());
+    if (ec) {
+        fmt::print(stderr, "Can't read directory {} ({})\n", dir.string(), ec.message());
+        return {};
+    }
+
+    // The order of import does not depend on the file system.
+    std::ranges::sort(files);
+    for (auto const& file : files) {
+        if (auto item = itemFromFile(file); item) {
+            ++stats_.read;
+            if (not write(*item))
+                return {};
+        }
+    }
+    return true;
+}
+
+/// JSON export - an array of notes.
+bool NoteImporter::
+importJson(fs::path const& path) noexcept {
+    auto const text = readFile(path);
+    if (not text) {
+        fmt::print(stderr, "Can't read file {}\n", path.string());
+        return {};
+    }
+
+    std::vector<Item> items{};
+    if (auto const ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(items, *text); ec) {
+        fmt::print(stderr, "Invalid JSON export {}: {}\n", path.string(), glz::format_error(ec, *text));
+        return {};
+    }
+
+    for (auto const& item : items) {
+        ++stats_.read;
+        if (not write(item))
+            return {};
+    }
+    return true;
+}
+
+/// Note for the file: the title is the name of the file
+/// (or the first heading of the Markdown document).
+std::optional<NoteImporter::Item> NoteImporter::
+itemFromFile(fs::path const& path) noexcept {
+    auto ext = path.extension().string();
+    std::ranges::transform(ext, ext.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    auto const html = (ext == ".html" or ext == ".htm");
+    auto const markdown = (ext == ".md" or ext == ".markdown");
+    if (not html and not markdown and ext != ".txt")
+        return {};
+
+    auto text = readFile(path);
+    if (not text) {
+        fmt::print(stderr, "Can't read file {}\n", path.string());
+        return {};
+    }
+
+    Item item{path.stem().string(), path.filename().string(), {}};
+    if (markdown and text->starts_with("# "))
+        item.title = shared::trim(text->substr(2, text->find('\n') - 2));
+    item.content = html ? std::move(*text) : textToHtml(*text, markdown);
+    return item;
+}
+
+/// Write a note to the database (transactions are opened and committed every 'batchSize' notes).
+/// \return false if the batch could not be committed (its notes were rolled back).
+bool NoteImporter::
+write(Item const& item) noexcept {
+    if (item.title.empty() or item.content.empty()) {
+        ++stats_.failed;
+        return true;
+    }
+    if (inBatch_ == 0 and not begin()) {
+        ++stats_.failed;
+        return true;
+    }
+
+    auto& db = SQLite::instance();
+    auto const id = db.insert(InsertQuery, categoryID_,
+                              value_t::ref(item.title),
+                              value_t::ref(item.description),
+                              value_t::ref(item.content));
+    if (id == SQLite::InvalidRowid)
+        ++stats_.failed;
+    else if (db.changes() == 0)
+        ++stats_.skipped;
+    else {
+        ++stats_.imported;
+        stats_.bytes += item.content.size();
+        batchIDs_.push_back(id);
+    }
+
+    if (++inBatch_ >= batchSize_)
+        return commit();
+    return true;
+}
+
+bool NoteImporter::
+begin() noexcept {
+    transaction_.emplace(SQLite::instance().transaction());
+    return bool(*transaction_);
+}
+
+/// Notes of the batch are added to the search index in the same transaction.
+bool NoteImporter::
+commit() noexcept {
+    inBatch_ = 0;
+    auto ok = transaction_ and Note::addToSearchIndex(batchIDs_);
+    if (ok)
+        ok = transaction_->commit();
+    else if (transaction_)
+        transaction_->rollback();
+    transaction_.reset();
+    batchIDs_.clear();
+    if (not ok)
+        fmt::print(stderr, "Can't commit the batch of notes, the import is aborted.\n");
+    return ok;
+}
+
+std::string NoteImporter::Stats::
+str() const noexcept {
+    auto const secs = std::max(seconds, 1e-9);
+    return fmt::format("read: {}, imported: {}, skipped: {}, failed: {} in {:.3f} s ({:.0f} notes/s, {:.2f} MB/s)",
+                       read, imported, skipped, failed, seconds,
+                       double(imported) / secs,
+                       double(bytes) / (1024. * 1024.) / secs);
+}
@@ -0,0 +1,65 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared.hh"
+#include "../sqlite/transaction.hh"
+#include <string>
+#include <optional>
+#include <vector>
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Bulk import of notes to the given category. \n
+/// The source is a directory with HTML, Markdown and plain text files
+/// (one note per file) or a JSON export (an array of objects with
+/// 'title', 'description' and 'content' fields). \n
+/// Notes are written with one prepared statement in transactions
+/// of 'batchSize' notes, so not every note costs a journal sync.
+class NoteImporter {
+public:
+    static constexpr std::size_t DefaultBatchSize = 1000;
+
+    struct Stats {
+        std::size_t read{};         // notes read from the source
+        std::size_t imported{};     // notes written to the database
+        std::size_t skipped{};      // notes already present (same title and description)
+        std::size_t failed{};       // notes which could not be read or written
+        std::size_t bytes{};        // size of the imported content
+        double seconds{};
+
+        [[nodiscard]] std::string str() const noexcept;
+    };
+
+    explicit NoteImporter(i64 categoryID, std::size_t batchSize = DefaultBatchSize) noexcept;
+
+    /// Import notes from the directory or the JSON file.
+    /// \return statistics, or nothing if the source could not be read
+    ///     or a batch of notes could not be committed.
+    std::optional<Stats> run(fs::path const& path) noexcept;
+
+private:
+    struct Item {
+        std::string title;
+        std::string description;
+        std::string content;
+    };
+
+    bool importDirectory(fs::path const& dir) noexcept;
+    bool importJson(fs::path const& path) noexcept;
+    static std::optional<Item> itemFromFile(fs::path const& path) noexcept;
+
+    bool write(Item const& item) noexcept;
+    bool begin() noexcept;
+    bool commit() noexcept;
+
+    i64 const categoryID_;
+    std::size_t const batchSize_;
+    std::size_t inBatch_{};
+    std::vector<i64> batchIDs_{};   // notes written in the current batch
+    std::optional<Transaction> transaction_{};
+    Stats stats_{};
+};
@@ -3,13 +3,118 @@
 //
 
 #include "StoreCategory.hh"
+#include "../common/EventController.hh"
+#include <numeric>
 
 using namespace std;
 
-StoreCategory::StoreCategory(QObject* parent) : QObject(parent) {
+StoreCategory::StoreCategory() noexcept {
+    collator_.setCaseSensitivity(Qt::CaseInsensitive);
+    load();
+}
+
+/// Odczyt kategorii i jednorazowe posortowanie dzieci każdej z nich
+/// (klucz sortowania wyznaczany jest raz dla każdej kategorii).
+void StoreCategory::
+load() noexcept {
+    data_.clear();
+    keys_.clear();
+    parents_.clear();
+
+    repository_t data{};
+    keys_t keys{};
     if (auto categories = Category::all(); categories) {
         for (auto&& category : categories.value()) {
-            data_[category.pid()].push_back(category);
+            parents_[category.id()] = category.pid();
+            keys[category.pid()].push_back(collator_.sortKey(category.qname()));
+            data[category.pid()].push_back(std::move(category));
         }
     }
+
+    for (auto& [pid, childs] : data) {
+        auto& childKeys = keys.at(pid);
+        vector<size_t> order(childs.size());
+        iota(order.begin(), order.end(), 0);
+        ranges::stable_sort(order, [&childKeys](auto const a, auto const b) {
+            return childKeys[a].compare(childKeys[b]) < 0;
+        });
+
+        auto& sorted = data_[pid];
+        auto& sortedKeys = keys_[pid];
+        sorted.reserve(order.size());
+        sortedKeys.reserve(order.size());
+        for (auto const i : order) {
+            sorted.push_back(std::move(childs[i]));
+            sortedKeys.push_back(std::move(childKeys[i]));
+        }
+    }
+}
+
+void StoreCategory::
+add(Category const& category) noexcept {
+    insert(category);
+    parents_[category.id()] = category.pid();
+    changed();
+}
+
+/// Nowa nazwa - kategoria zmienia miejsce wśród rodzeństwa.
+bool StoreCategory::
+rename(i64 const pid, i64 const id, std::string const& name) noexcept {
+    auto const index = indexOf(pid, id);
+    if (not index)
+        return false;
+
+    auto category = data_[pid][*index];
+    category.name(name);
+    erase(pid, id);
+    insert(std::move(category));
+    changed();
+    return true;
+}
+
+bool StoreCategory::
+remove(i64 const pid, i64 const id) noexcept {
+    if (not erase(pid, id))
+        return false;
+    data_.erase(id);
+    keys_.erase(id);
+    parents_.erase(id);
+    changed();
+    return true;
+}
+
+/// Wstawienie kategorii między dzieci rodzica z zachowaniem kolejności
+/// (wyszukiwanie binarne po kluczach sortowania).
+void StoreCategory::
+insert(Category category) noexcept {
+    auto key = collator_.sortKey(category.qname());
+    auto& childs = data_[category.pid()];
+    auto& childKeys = keys_[category.pid()];
+
+    auto const it = ranges::upper_bound(childKeys, key, [](auto const& a, auto const& b) {
+        return a.compare(b) < 0;
+    });
+    auto const index = it - childKeys.begin();
+    childKeys.insert(it, std::move(key));
+    childs.insert(childs.begin() + index, std::move(category));
+}
+
+/// Usunięcie kategorii z dzieci rodzica (bez jej własnych dzieci).
+bool StoreCategory::
+erase(i64 const pid, i64 const id) noexcept {
+    auto const index = indexOf(pid, id);
+    if (not index)
+        return false;
+    auto& childs = data_[pid];
+    auto& childKeys = keys_[pid];
+    childs.erase(childs.begin() + *index);
+    childKeys.erase(childKeys.begin() + *index);
+    return true;
+}
+
+/// Nowa generacja kategorii - informujemy wszystkich zainteresowanych.
+void StoreCategory::
+changed() noexcept {
+    ++generation_;
+    EventController::instance().send(event::CategoriesChanged, qint64(generation_));
 }
@@ -4,17 +4,32 @@
 
 #pragma once
 
-#include <QObject>
 #include "category.hh"
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <algorithm>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 #include <fmt/core.h>
 
-class StoreCategory : QObject {
+/// Wspólny (jeden dla całego programu) magazyn kategorii. \n
+/// Kategorie są odczytywane z bazy danych raz, przy pierwszym użyciu.
+/// Każda zmiana (add, rename, remove) zwiększa numer generacji
+/// i jest ogłaszana zdarzeniem 'CategoriesChanged' - widżety nie odczytują
+/// kategorii od nowa, tylko porównują generację z tą, którą pokazują. \n
+/// Dzieci każdej kategorii są przechowywane posortowane (alfabetycznie, bez
+/// rozróżniania wielkości liter) wg kluczy sortowania wyznaczonych raz dla
+/// każdej kategorii - budowanie drzewa nie porównuje nazw. \n
+/// Używany tylko w wątku GUI.
+class StoreCategory {
     using repository_t = std::unordered_map<i64, std::vector<Category>>;
-    Q_OBJECT
+    using keys_t = std::unordered_map<i64, std::vector<QCollatorSortKey>>;
 public:
-    explicit StoreCategory(QObject* = nullptr);
+    static StoreCategory& instance() noexcept {
+        static StoreCategory store;
+        return store;
+    }
 
     // co copy
     StoreCategory(StoreCategory const&) = delete;
@@ -32,15 +47,58 @@ public:
         }
     }
 
-    bool hasSubcategories(i64 const id) noexcept {
-        return not data_[id].empty();
+    /// Numer generacji - zmienia się przy każdej zmianie kategorii.
+    [[nodiscard]] u64 generation() const noexcept {
+        return generation_;
+    }
+
+    bool hasSubcategories(i64 const id) const noexcept {
+        auto const it = data_.find(id);
+        return it != data_.end() and not it->second.empty();
     }
-    bool exist(i64 const pid, std::string const& name) noexcept {
-        return std::ranges::any_of(data_[pid], [name](auto const& c) {
+    bool exist(i64 const pid, std::string const& name) const noexcept {
+        return std::ranges::any_of(childrenOf(pid), [&name](auto const& c) {
             return c.name() == name;
         });
     }
 
+    /// Dodanie nowej kategorii (zapisanej już w bazie danych).
+    void add(Category const& category) noexcept;
+    /// Zmiana nazwy kategorii.
+    bool rename(i64 pid, i64 id, std::string const& name) noexcept;
+    /// Usunięcie kategorii (bez podkategorii).
+    bool remove(i64 pid, i64 id) noexcept;
+
+    /// Numery ID kategorii od kategorii głównej do wskazanej (włącznie).
+    std::vector<i64> pathTo(i64 id) const noexcept {
+        std::vector<i64> path{};
+        while (id != 0 and path.size() <= parents_.size()) {
+            auto const it = parents_.find(id);
+            if (it == parents_.end())
+                return {};
+            path.push_back(id);
+            id = it->second;
+        }
+        std::ranges::reverse(path);
+        return path;
+    }
+
+    /// Pozycja kategorii wśród (posortowanych) dzieci rodzica.
+    std::optional<int> indexOf(i64 const pid, i64 const id) const noexcept {
+        auto const& childs = childrenOf(pid);
+        auto const it = std::ranges::find_if(childs, [id](auto const& c) { return c.id() == id; });
+        if (it == childs.end())
+            return {};
+        return int(it - childs.begin());
+    }
+
+    /// Dzieci kategorii posortowane wg nazw (bez kopiowania).
+    std::vector<Category> const& childrenOf(i64 const pid) const noexcept {
+        static std::vector<Category> const empty{};
+        auto const it = data_.find(pid);
+        return it != data_.end() ? it->second : empty;
+    }
+
     std::vector<Category> childsForParentWithID(int const pid) const noexcept {
         auto it = data_.find(pid);
         if (it != data_.end())
@@ -48,7 +106,29 @@ public:
         return {};
     }
 
+    /// Wywołanie funkcji dla każdej kategorii (bez kopiowania).
+    template<typename F>
+    void forEach(F&& fn) const {
+        for (auto const& [_, childs] : data_)
+            for (auto const& category : childs)
+                fn(category);
+    }
+
+    /// Liczba wszystkich kategorii.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return parents_.size();
+    }
+
 private:
-    repository_t data_{};
+    StoreCategory() noexcept;
+    void load() noexcept;
+    void changed() noexcept;
+    void insert(Category category) noexcept;
+    bool erase(i64 pid, i64 id) noexcept;
 
+    QCollator collator_{};
+    repository_t data_{};
+    keys_t keys_{};                             // pid -> klucze sortowania dzieci (jak w 'data_')
+    std::unordered_map<i64, i64> parents_{};    // id -> pid
+    u64 generation_{1};
 };
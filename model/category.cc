@@ -3,16 +3,17 @@
 //
 
 #include "category.hh"
+#include "CategoryIndex.hh"
 
 using namespace std;
 
 Category::Category(Row&& row) {
-    if (auto field = row["id"]; field)
-        id_  = field.value().value().int64();
-    if (auto field = row["pid"]; field)
-        pid_  = field.value().value().int64();
-    if (auto field = row["name"]; field)
-        name_  = field.value().value().str();
+    if (auto value = row["id"]; value)
+        id_  = value->int64();
+    if (auto value = row["pid"]; value)
+        pid_  = value->int64();
+    if (auto value = row["name"]; value)
+        name_  = std::move(*value).str();
 }
 
 optional<vector<Category>> Category::
@@ -21,7 +22,7 @@ all() noexcept {
     auto query{"SELECT * FROM category"s};
 
     if (auto selected = SQLite::instance().select(query); selected) {
-        if (auto result = selected.value(); not result.empty()) {
+        if (auto& result = selected.value(); not result.empty()) {
             vector<Category> vec{};
             vec.reserve(result.size());
             for (auto&& row: result)
@@ -37,8 +38,8 @@ std::optional<Category> Category::
 withID(i64 const id, std::string const& fields) noexcept {
     auto query = fmt::format("SELECT {} FROM category WHERE id=?", fields);
     if (auto result = SQLite::instance().select(query, id); result)
-        if (auto data = result.value(); not data.empty())
-            return Category(data[0]);
+        if (auto& data = result.value(); not data.empty())
+            return Category(std::move(data[0]));
 
     return {};
 }
@@ -49,7 +50,7 @@ withPID(i64 const pid, std::string const& fields) noexcept {
 
     auto query = fmt::format("SELECT {} FROM category WHERE pid=?", fields);
     if (auto opt = SQLite::instance().select(query, pid); opt)
-        if (auto result = opt.value(); not result.empty())
+        if (auto& result = opt.value(); not result.empty())
             for (auto&& row : result)
                 data.emplace_back(std::move(row));
 
@@ -60,43 +61,46 @@ withPID(i64 const pid, std::string const& fields) noexcept {
 std::optional<std::string> Category::
 nameWithID(i64 id) noexcept {
     if (auto opt = SQLite::instance().select("SELECT name FROM category WHERE id=?", id); opt) {
-        if (auto result = opt.value(); result.size() == 1) {
-            if (auto field = result[0]["name"]; field)
-                return (*field).value().str();
+        if (auto& result = opt.value(); result.size() == 1) {
+            if (auto value = result[0]["name"]; value)
+                return value->str();
         }
     }
     return {};
 }
 
-std::optional<std::vector<std::string>> Category::
-namesChainFor(i64 const id) noexcept {
-    std::vector<std::string> names{};
-    auto currentID = id;
-
-    while (auto opt = withID(currentID, "pid, name")) {
-        auto category = *opt;
-        names.push_back(std::move(category.name_));
-        if (category.pid_ == 0) break;
-        currentID = category.pid_;
-    }
+/// Liczba notatek kategorii (bez notatek podkategorii).
+std::optional<i64> Category::
+notesCount(i64 const id) noexcept {
+    using CountQuery = sql::query<"SELECT COUNT(*) FROM note WHERE pid=?", i64>;
+    if (auto row = SQLite::instance().fetch_one<CountQuery>(id); row)
+        return std::get<0>(*row);
+    return {};
+}
 
-    if (names.empty())
+/// Usunięcie kategorii wraz z jej notatkami (w jednej transakcji -
+/// albo wszystko, albo nic).
+bool Category::
+remove(i64 const id) noexcept {
+    auto& db = SQLite::instance();
+    auto transaction = db.transaction();
+    if (not transaction)
+        return {};
+    if (not db.exec("DELETE FROM note WHERE pid=?", id) or not db.exec("DELETE FROM category WHERE id=?", id)) {
+        transaction.rollback();
         return {};
+    }
+    return transaction.commit();
+}
 
-    std::reverse(names.begin(), names.end());
-    return names;
+/// Nazwy kategorii od kategorii głównej do wskazanej (z indeksu w pamięci).
+std::optional<std::vector<std::string>> Category::
+namesChainFor(i64 const id) noexcept {
+    return CategoryIndex::instance().namesChain(id);
 }
 
+/// Numery ID kategorii i wszystkich jej podkategorii (z indeksu w pamięci).
 std::vector<i64> Category::
 idsSubchainFor(i64 const id) noexcept {
-    std::vector<i64> ids{id};
-
-    for (auto const& child : withPID(id)) {
-        auto data = idsSubchainFor(child.id_);
-        std::copy(data.begin(), data.end(), std::back_inserter(ids));
-    }
-
-    ids.shrink_to_fit();
-    std::sort(ids.begin(), ids.end());
-    return ids;
+    return CategoryIndex::instance().subtree(id);
 }
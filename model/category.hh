@@ -54,6 +54,8 @@ public:
     static std::vector<Category> withPID(i64 pid, std::string const& fields = "*") noexcept;
     static std::optional<std::string> nameWithID(i64 id) noexcept;
     static std::optional<std::vector<Category>> all() noexcept;
+    static std::optional<i64> notesCount(i64 id) noexcept;
+    static bool remove(i64 id) noexcept;
 
     [[nodiscard]] std::string str() const noexcept {
         return fmt::format("id:{}, pid:{}, name:{}", id_, pid_, name_);
@@ -4,24 +4,24 @@
 
 #include "note.hh"
 #include "../sqlite/sqlite.hh"
-#include <numeric>
+#include <cctype>
 #include <string>
 #include <fmt/core.h>
-#include <range/v3/range.hpp>
 
 Note::Note(Row &&row) {
+    // Teksty są przenoszone z wiersza, nie kopiowane.
     if (auto f = row["id"]; f)
-        id_ = (*f).value().int64();
+        id_ = f->int64();
     if (auto f = row["pid"]; f)
-        pid_ = (*f).value().int64();
+        pid_ = f->int64();
     if (auto f = row["title"]; f)
-        title_ = (*f).value().str();
+        title_ = std::move(*f).str();
     if (auto f = row["description"]; f)
-        description_ = (*f).value().str();
+        description_ = std::move(*f).str();
     if (auto f = row["content"]; f)
-        content_ = (*f).value().str();
+        content_ = std::move(*f).str();
     if (auto f = row["name"]; f)
-        category_ = (*f).value().str();
+        category_ = std::move(*f).str();
 }
 
 bool Note::
@@ -35,28 +35,20 @@ remove(i64 const id) noexcept {
 /// \return True jeśli znaleziono notatkę, False w przeciwnym przypadku
 bool Note::
 containsParentTheNoteWithTitle(i64 categoryID, std::string const& title) noexcept {
-    auto countQuery = "SELECT COUNT(*) as count FROM note WHERE pid=? AND title=?";
-    if (auto result = SQLite::instance().select(countQuery, categoryID, title); result) {
-        if (auto data = *result; data.size() == 1) {
-            auto row = data[0];
-            if (auto field = row["count"]; field) {
-                if (auto n = (*field).value().int64(); n > 0)
-                    return true;
-            }
-        }
-    }
+    using CountQuery = sql::query<"SELECT COUNT(*) FROM note WHERE pid=? AND title=?", i64>;
+    if (auto row = SQLite::instance().fetch_one<CountQuery>(categoryID, title); row)
+        return std::get<0>(*row) > 0;
     return {};
 }
 
 /// Odczyt danych notatki posiadającej wskazany numer ID.
 std::optional<Note> Note::
 withID(i64 const noteID, std::string const &fields) noexcept {
-    auto selectQuery = fmt::format("SELECT note.*, category.name FROM note INNER JOIN category ON category.id=note.pid WHERE note.id=?");
-    if (auto result = SQLite::instance().select(selectQuery, noteID); result)
-        if (auto data = *result; data.size() == 1)
-            return Note(data[0]);
-
-    return {};
+    using SelectQuery = sql::query_as<Note,
+            "SELECT note.id, note.pid, note.title, note.description, note.content, category.name "
+            "FROM note INNER JOIN category ON category.id=note.pid WHERE note.id=?",
+            i64, i64, std::string, std::string, std::string, std::string>;
+    return SQLite::instance().fetch_one<SelectQuery>(noteID);
 }
 
 /// Dodanie do bazy danych wiersza z nową notatką.
@@ -66,11 +58,24 @@ bool Note::
 insert() noexcept {
     using namespace std::string_literals;
     auto cmd{"INSERT INTO note (pid, title, description, content) VALUES (?,?,?,?)"s};
-    if (auto id = SQLite::instance().insert(cmd, pid_, title_, description_, content_); id > 0) {
-        id_ = id;
-        return true;
+    auto& db = SQLite::instance();
+    // Notatka i jej wpis w indeksie wyszukiwania - razem albo wcale.
+    auto transaction = db.transaction();
+    if (not transaction)
+        return {};
+    // Teksty notatki nie są kopiowane - zapytanie tylko je wskazuje.
+    auto const id = db.insert(cmd, pid_,
+                              value_t::ref(title_),
+                              value_t::ref(description_),
+                              value_t::ref(content_));
+    if (id <= 0 or not addToSearchIndex({id})) {
+        transaction.rollback();
+        return {};
     }
-    return {};
+    if (not transaction.commit())
+        return {};
+    id_ = id;
+    return true;
 }
 
 /// Uaktualnienie danych notatki. \n
@@ -79,32 +84,224 @@ bool Note::
 update() noexcept {
     using namespace std::string_literals;
     auto cmd{"UPDATE note SET pid=?, title=?, description=?, content=? WHERE id=?"s};
-    return SQLite::instance().update(cmd, pid_, title_, description_, content_, id_);
+    auto& db = SQLite::instance();
+    // Wyzwalacz usuwa stary wpis w indeksie wyszukiwania, nowy dodajemy sami.
+    auto transaction = db.transaction();
+    if (not transaction)
+        return {};
+    auto const ok = db.update(cmd, pid_,
+                              value_t::ref(title_),
+                              value_t::ref(description_),
+                              value_t::ref(content_),
+                              id_);
+    if (not ok or (db.changes() > 0 and not addToSearchIndex({id_}))) {
+        transaction.rollback();
+        return {};
+    }
+    return transaction.commit();
+}
+
+/// Zamiana tekstu wpisanego przez użytkownika na zapytanie FTS5. \n
+/// Każde słowo jest ujęte w cudzysłów (znaki specjalne FTS5 nie są interpretowane)
+/// i szukane jako prefiks - 'note pro' znajdzie 'notes programming'.
+static std::string
+ftsQuery(std::string const& text) noexcept {
+    std::string query{};
+    std::string word{};
+
+    auto flush = [&] {
+        if (word.empty()) return;
+        if (not query.empty()) query += ' ';
+        query += fmt::format("\"{}\"*", word);
+        word.clear();
+    };
+
+    for (auto const c : text) {
+        if (std::isspace(static_cast<unsigned char>(c)))
+            flush();
+        else if (c == '"')
+            word += "\"\"";
+        else
+            word += c;
+    }
+    flush();
+    return query;
+}
+
+/// Wyszukanie notatek zawierających wszystkie słowa z tekstu 'text'
+/// (w tytule, opisie lub treści). \n
+/// Wyniki są posortowane wg trafności (bm25), tytuł waży najwięcej.
+/// \param limit - maksymalna liczba zwracanych notatek.
+std::vector<SearchHit> Note::
+search(std::string const& text, int const limit) noexcept {
+    using SearchQuery = sql::query_as<SearchHit,
+            "SELECT note.id, note.pid, note.title, note.description, category.name, "
+            "snippet(note_fts, -1, char(2), char(3), '…', 16) "
+            "FROM note_fts "
+            "INNER JOIN note ON note.id=note_fts.rowid "
+            "INNER JOIN category ON category.id=note.pid "
+            "WHERE note_fts MATCH ? "
+            "ORDER BY bm25(note_fts, 10.0, 5.0, 1.0) "
+            "LIMIT ?",
+            i64, i64, std::string, std::string, std::string, std::string>;
+
+    auto const query = ftsQuery(text);
+    if (query.empty())
+        return {};
+    auto hits = SQLite::instance().fetch<SearchQuery>(query, limit);
+    if (not hits)
+        return {};
+
+    // Fragment tekstu jest wyświetlany jako HTML - najpierw znaki specjalne,
+    // potem znaczniki (\x02, \x03) otaczające znalezione słowa.
+    for (auto& hit : *hits) {
+        std::string html{};
+        html.reserve(hit.snippet.size() + 32);
+        for (auto const c : hit.snippet) {
+            switch (c) {
+                case '\x02': html += "<b>"; break;
+                case '\x03': html += "</b>"; break;
+                case '&': html += "&amp;"; break;
+                case '<': html += "&lt;"; break;
+                case '>': html += "&gt;"; break;
+                default: html += c;
+            }
+        }
+        hit.snippet = std::move(html);
+    }
+    return std::move(*hits);
+}
+
+/// Utworzenie indeksu wyszukiwania w bazie danych utworzonej przez
+/// wcześniejszą wersję programu i dodanie do indeksu notatek zapisanych
+/// przez innych klientów bazy danych (wyzwalacze tylko usuwają wpisy -
+/// zob. SearchCreationCmd). \n
+/// Zwykle indeks jest aktualny - wtedy wystarczy odczyt, transakcja
+/// zapisu jest otwierana tylko gdy jest coś do zrobienia.
+/// \return True jeśli indeks jest aktualny, False w przeciwnym przypadku.
+bool Note::
+createSearchIndexIfNeeded() noexcept {
+    using ExistsQuery = sql::query<"SELECT COUNT(*) FROM sqlite_master WHERE type='table' AND name='note_fts'", i64>;
+    using UnindexedQuery = sql::query<"SELECT EXISTS (SELECT 1 FROM note WHERE id NOT IN (SELECT rowid FROM note_fts))", i64>;
+    auto& db = SQLite::instance();
+    auto const exists = db.fetch_one<ExistsQuery>();
+    if (not exists)
+        return {};
+    auto const created = std::get<0>(*exists) > 0;
+    if (created) {
+        auto const unindexed = db.fetch_one<UnindexedQuery>();
+        if (not unindexed)
+            return {};
+        if (std::get<0>(*unindexed) == 0)
+            return true;
+    }
+
+    auto transaction = db.transaction();
+    if (not transaction)
+        return {};
+    auto ok = true;
+    if (not created)
+        for (auto const& cmd : SearchCreationCmd)
+            ok = ok and db.exec(cmd);
+    ok = ok and db.exec("INSERT INTO note_fts (rowid, title, description, content) "
+                        "SELECT id, title, description, strip_html(content) FROM note "
+                        "WHERE id NOT IN (SELECT rowid FROM note_fts)");
+    if (not ok) {
+        transaction.rollback();
+        return {};
+    }
+    return transaction.commit();
+}
+
+/// Numery ID jako tablica JSON (np. '[1,2,3]'), parametr zapytań
+/// z 'IN (SELECT value FROM json_each(?))' - tekst zapytania się nie zmienia.
+static std::string
+jsonArray(std::vector<i64> const& ids) noexcept {
+    std::string text{"["};
+    text.reserve(ids.size() * 8 + 2);
+    for (auto const id : ids) {
+        if (text.size() > 1)
+            text += ',';
+        text += std::to_string(id);
+    }
+    text += ']';
+    return text;
+}
+
+/// Wpisy notatek w indeksie wyszukiwania (treść bez znaczników HTML). \n
+/// Wpisy usuwają wyzwalacze, więc notatka nie może mieć już wpisu.
+bool Note::
+addToSearchIndex(std::vector<i64> const& ids) noexcept {
+    if (ids.empty())
+        return true;
+    return SQLite::instance().exec(
+            "INSERT INTO note_fts (rowid, title, description, content) "
+            "SELECT id, title, description, strip_html(content) FROM note "
+            "WHERE id IN (SELECT value FROM json_each(?))", jsonArray(ids));
+}
+
+/// Kolumny notatek bez treści (nagłówki), opis może być NULL.
+static std::string_view const HeaderFields{
+    "note.id, note.pid, note.title, IFNULL(note.description, '') AS description, category.name"};
+
+/// Nagłówek notatki z wiersza zapytania z kolumnami 'HeaderFields' (teksty są przenoszone).
+static NoteHeader
+headerFrom(Row&& row) noexcept {
+    return NoteHeader{
+        .id = row.at(0).int64(),
+        .pid = row.at(1).int64(),
+        .title = std::move(row).at(2).str(),
+        .description = std::move(row).at(3).str(),
+        .category = std::move(row).at(4).str()
+    };
+}
+
+/// Tekst zapytania o notatki należące do kategorii, których numery ID
+/// są parametrem zapytania (tablica JSON - zob. jsonArray).
+/// \param fields - odczytywane kolumny.
+static std::string
+notesQuery(std::string_view const fields = "note.*, category.name") noexcept {
+    return fmt::format("SELECT {} FROM note INNER JOIN category ON category.id=note.pid "
+                       "WHERE note.pid IN (SELECT value FROM json_each(?))", fields);
+}
+
+/// Numery ID notatek kategorii 'categoryIDs' w kolejności tytułów. \n
+/// Same numery są małe - lista może mieć dziesiątki tysięcy pozycji.
+std::vector<i64> Note::
+idsInCategories(std::vector<i64> const& categoryIDs) noexcept {
+    std::vector<i64> ids{};
+    if (categoryIDs.empty())
+        return ids;
+
+    auto cursor = SQLite::instance().cursor("SELECT id FROM note WHERE pid IN (SELECT value FROM json_each(?)) ORDER BY title, id",
+                                            jsonArray(categoryIDs));
+    for (auto&& row : cursor)
+        ids.push_back(row.at(0).int64());
+    return ids;
+}
+
+/// Odczyt nagłówków notatek o numerach ID z wektora 'noteIDs' (kolejność dowolna).
+std::vector<NoteHeader> Note::
+headersWithIDs(std::vector<i64> const& noteIDs) noexcept {
+    std::vector<NoteHeader> vec{};
+    if (noteIDs.empty())
+        return vec;
+
+    vec.reserve(noteIDs.size());
+    auto const query = fmt::format("SELECT {} FROM note INNER JOIN category ON category.id=note.pid "
+                                   "WHERE note.id IN (SELECT value FROM json_each(?))", HeaderFields);
+    auto cursor = SQLite::instance().cursor(query, jsonArray(noteIDs));
+    for (auto&& row : cursor)
+        vec.push_back(headerFrom(std::move(row)));
+    return vec;
 }
 
 /// Odczyt z bazy danych notatek których numery ID są podane jako argument w wektorze 'ids'.
 std::vector<Note> Note::
 notes(std::vector<i64> ids) noexcept {
-    // konwersja liczb na tekst
-    auto data = ids |
-               ranges::views::transform([](i64 const i) { return std::to_string(i); }) |
-               ranges::to<std::vector>();
-
-    // połączenie (join) tekstów z użyciem przecinka
-    auto acc = std::accumulate(
-            std::next(data.begin()),
-            data.end(),
-            data[0],
-            [](auto a, auto b) {
-                return fmt::format("{},{}", a, b);
-            });
-
-
-// "SELECT note.*, category.name FROM note INNER JOIN category ON category.id=note.pid WHERE note.id=?"
     std::vector<Note> vec{};
-    auto cmd = fmt::format("SELECT note.*, category.name FROM note INNER JOIN category ON category.id=note.pid WHERE note.pid IN ({})", acc);
 
-    if (auto opt = SQLite::instance().select(cmd); opt) {
+    if (auto opt = SQLite::instance().select(notesQuery(), jsonArray(ids)); opt) {
         for (auto row : opt.value()) {
             vec.emplace_back(std::move(row));
         }
@@ -113,3 +310,71 @@ notes(std::vector<i64> ids) noexcept {
     vec.shrink_to_fit();
     return vec;
 }
+
+/// Odczyt notatek kategorii 'ids' po jednej (bez gromadzenia ich w pamięci). \n
+/// Każda odczytana notatka jest przekazywana do funkcji 'fn'.
+/// \return True jeśli odczyt zakończył się sukcesem, False w przeciwnym przypadku.
+bool Note::
+forEach(std::vector<i64> const& ids, std::function<void(Note&&)> const& fn) noexcept {
+    if (ids.empty())
+        return true;
+
+    auto cursor = SQLite::instance().cursor(notesQuery(), jsonArray(ids));
+    for (auto&& row : cursor)
+        fn(Note(std::move(row)));
+    return not cursor.failed();
+}
+
+/// Odczyt nagłówków (bez treści) notatek kategorii o numerach ID z wektora 'ids'.
+std::vector<NoteHeader> Note::
+headers(std::vector<i64> const& ids) noexcept {
+    std::vector<NoteHeader> vec{};
+    forEachHeader(ids, [&vec](NoteHeader&& header) {
+        vec.push_back(std::move(header));
+    });
+    vec.shrink_to_fit();
+    return vec;
+}
+
+/// Odczyt nagłówków (bez treści) notatek kategorii 'ids' po jednym. \n
+/// Każdy odczytany nagłówek jest przekazywany do funkcji 'fn'.
+/// \return True jeśli odczyt zakończył się sukcesem, False w przeciwnym przypadku.
+bool Note::
+forEachHeader(std::vector<i64> const& ids, std::function<void(NoteHeader&&)> const& fn) noexcept {
+    if (ids.empty())
+        return true;
+
+    auto cursor = SQLite::instance().cursor(notesQuery(HeaderFields), jsonArray(ids));
+    for (auto&& row : cursor)
+        fn(headerFrom(std::move(row)));
+    return not cursor.failed();
+}
+
+/// Odczyt samej treści notatki (np. do wyświetlenia wybranej notatki).
+std::optional<std::string> Note::
+contentWithID(i64 const noteID) noexcept {
+    using ContentQuery = sql::query<"SELECT content FROM note WHERE id=?", std::string>;
+    if (auto row = SQLite::instance().fetch_one<ContentQuery>(noteID); row)
+        return std::move(std::get<0>(*row));
+    return {};
+}
+
+/// Odczyt notatek kategorii 'categoryID' i wszystkich jej podkategorii jednym zapytaniem. \n
+/// Poddrzewo kategorii wyznacza rekurencyjne CTE (indeks category_pid_index),
+/// tekst zapytania jest stały - polecenie jest przygotowywane tylko raz (cache).
+/// \return True jeśli odczyt zakończył się sukcesem, False w przeciwnym przypadku.
+bool Note::
+forEachInSubtree(i64 const categoryID, std::function<void(Note&&)> const& fn) noexcept {
+    // UNION (nie UNION ALL) - cykl w danych nie zapętli zapytania.
+    using SubtreeQuery = sql::query_as<Note,
+            "WITH RECURSIVE subtree(id) AS ("
+            "    SELECT ?"
+            "    UNION"
+            "    SELECT category.id FROM category INNER JOIN subtree ON category.pid=subtree.id"
+            ") "
+            "SELECT note.id, note.pid, note.title, note.description, note.content, category.name "
+            "FROM note INNER JOIN category ON category.id=note.pid "
+            "WHERE note.pid IN subtree",
+            i64, i64, std::string, std::string, std::string, std::string>;
+    return SQLite::instance().for_each<SubtreeQuery>(fn, categoryID);
+}
@@ -11,6 +11,31 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <functional>
+
+/// Note found by the full-text search.
+struct SearchHit {
+    i64 id{};
+    i64 pid{};
+    std::string title{};
+    std::string description{};
+    std::string category{};
+    std::string snippet{};      // HTML fragment of the text, found words are in <b>
+};
+
+/// Note without its content - for the lists of notes
+/// (the content is read only when the note is displayed).
+struct NoteHeader {
+    i64 id{};
+    i64 pid{};
+    std::string title{};
+    std::string description{};
+    std::string category{};
+
+    [[nodiscard]] QString qtitle() const noexcept { return QString::fromStdString(title); }
+    [[nodiscard]] QString qdescription() const noexcept { return QString::fromStdString(description); }
+    [[nodiscard]] QString qcategory() const noexcept { return QString::fromStdString(category); }
+};
 
 class Note {
     i64 id_{};
@@ -22,6 +47,12 @@ class Note {
 public:
     Note() = default;
     explicit Note(Row&& row);
+    Note(i64 id, i64 pid, std::string title, std::string description, std::string content, std::string category)
+        : id_{id}, pid_{pid}
+        , title_{std::move(title)}
+        , description_{std::move(description)}
+        , content_{std::move(content)}
+        , category_{std::move(category)} {}
     Note(Note&&) = default;
     Note& operator=(Note&&) = default;
     Note(Note const&) = default;
@@ -31,7 +62,18 @@ public:
     static bool remove(i64 id) noexcept;
     static std::optional<Note> withID(i64 id, std::string const& fields = "*") noexcept;
     static std::vector<Note> notes(std::vector<i64> ids) noexcept;
+    static bool forEach(std::vector<i64> const& ids, std::function<void(Note&&)> const& fn) noexcept;
+    static bool forEachInSubtree(i64 categoryID, std::function<void(Note&&)> const& fn) noexcept;
+    static std::vector<NoteHeader> headers(std::vector<i64> const& ids) noexcept;
+    static bool forEachHeader(std::vector<i64> const& ids, std::function<void(NoteHeader&&)> const& fn) noexcept;
+    static std::optional<std::string> contentWithID(i64 id) noexcept;
+    static std::vector<i64> idsInCategories(std::vector<i64> const& categoryIDs) noexcept;
+    static std::vector<NoteHeader> headersWithIDs(std::vector<i64> const& noteIDs) noexcept;
     static bool containsParentTheNoteWithTitle(i64 categoryID, std::string const& title) noexcept;
+    static std::vector<SearchHit> search(std::string const& text, int limit = 200) noexcept;
+    static bool createSearchIndexIfNeeded() noexcept;
+    /// Add notes (already written) to the full-text search index.
+    static bool addToSearchIndex(std::vector<i64> const& ids) noexcept;
 
     [[nodiscard]] std::string const& title() const noexcept { return title_; }
     [[nodiscard]] QString qtitle() const noexcept { return QString::fromStdString(title_); }
@@ -104,5 +146,37 @@ public:
             },
 
     };
+
+    /// Full-text search index (FTS5) of notes. \n
+    /// The index stores its own copy of the texts, the content without HTML markup. \n
+    /// The schema deliberately uses no application functions: any SQLite client
+    /// (the sqlite3 shell, backup and repair scripts) can still write to 'note'.
+    /// Triggers only remove the entries of deleted or changed notes. The application
+    /// adds the entries (addToSearchIndex, using strip_html on its own connection).
+    /// Notes added or changed by other clients are indexed at the next start
+    /// (createSearchIndexIfNeeded).
+    static inline std::vector<std::string> const SearchCreationCmd{
+            {
+            R"(
+                CREATE VIRTUAL TABLE note_fts USING fts5(
+                    title, description, content,
+                    tokenize='unicode61 remove_diacritics 2'
+                );)"
+            },
+            {
+            R"(
+                CREATE TRIGGER note_fts_delete AFTER DELETE ON note
+                BEGIN
+                    DELETE FROM note_fts WHERE rowid = old.id;
+                END;)"
+            },
+            {
+            R"(
+                CREATE TRIGGER note_fts_update AFTER UPDATE OF title, description, content ON note
+                BEGIN
+                    DELETE FROM note_fts WHERE rowid = old.id;
+                END;)"
+            },
+    };
 };
 
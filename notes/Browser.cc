@@ -27,6 +27,7 @@
 #include "Browser.hh"
 #include "Settings.hh"
 #include "../common/EventController.hh"
+#include "../common/DatabaseExecutor.hh"
 #include "../model/note.hh"
 #include <QEvent>
 #include <fmt/core.h>
@@ -52,7 +53,8 @@ Browser::Browser(QWidget* const parent) : QTextEdit(parent) {
 
     EventController::instance().append(this,
                                        event::NoteSelected,
-                                       event::CategorySelected);
+                                       event::CategorySelected,
+                                       event::NoteContentLoaded);
 }
 
 Browser::~Browser() {
@@ -60,17 +62,27 @@ Browser::~Browser() {
 }
 
 void Browser::customEvent(QEvent* const event) {
-    auto const e = dynamic_cast<Event*>(event);
+    auto const e = static_cast<Event*>(event);
     switch (int(e->type())) {
         case event::NoteSelected:
-            if (auto data = e->data(); data.size() == 1) {
-                if (auto note = Note::withID(data[0].toInt()); note) {
-                    auto html = (*note).qcontent();
-                    setHtml(html);
-                }
+            // Lista notatek nie zawiera treści - odczytujemy ją dopiero teraz
+            // (w wątku bazy danych).
+            pending_ = DatabaseExecutor::instance().post(event::NoteContentLoaded,
+                                                         [id = e->payload<event::NoteSelected>().noteID] {
+                if (auto content = Note::contentWithID(id); content)
+                    return QString::fromStdString(*content);
+                return QString{};
+            });
+            break;
+        case event::NoteContentLoaded:
+            // Tylko treść ostatnio wybranej notatki.
+            if (auto data = e->data(); data.size() == 2 and u64(data[0].toLongLong()) == pending_) {
+                if (auto const content = data[1].toString(); not content.isNull())
+                    setHtml(content);
             }
             break;
         case event::CategorySelected:
+            pending_ = 0;
             setPlainText("");
             break;
     }
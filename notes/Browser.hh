@@ -25,6 +25,7 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
+#include "../shared.hh"
 #include <QTextEdit>
 
 /*------- forward declarations:
@@ -35,6 +36,8 @@ class QEvent;
 -------------------------------------------------------------------*/
 class Browser : public QTextEdit {
     Q_OBJECT
+    // Ostatnie zlecenie odczytu treści notatki.
+    u64 pending_{};
 public:
     explicit Browser(QWidget* = nullptr);
     ~Browser() override;
@@ -31,7 +31,6 @@
 #include <QMenu>
 #include <QLabel>
 #include <QFrame>
-#include <QTimer>
 #include <QString>
 #include <QDialog>
 #include <QAction>
@@ -42,7 +41,6 @@
 #include <QMessageBox>
 #include <QApplication>
 #include <QTreeWidgetItem>
-#include <QTreeWidgetItemIterator>
 #include <QDialogButtonBox>
 #include <memory>
 #include <string>
@@ -52,34 +50,14 @@
 -------------------------------------------------------------------*/
 std::string const CategoryTree::InsertQuery{"INSERT INTO category (pid, name) VALUES (?,?)"};
 std::string const CategoryTree::UpdateQuery{"UPDATE category SET name=? WHERE id=?"};
-std::string const CategoryTree::DeleteQuery{"DELETE FROM category WHERE id=?"};
 
 static char const* const RemoveTitle = "The category cannot be deleted.";
 static char const* const RemoveMessage = "This category cannot be deleted because it has subcategories!";
+static char const* const DeleteTitle = "Delete the category";
 
 CategoryTree::CategoryTree(QWidget* const parent) :
-    QTreeWidget(parent),
-    timer_(new QTimer(this))
+    QTreeWidget(parent)
 {
-    // !!! Konfiguracja timera !!!
-    // Timer jest nadawcą zdarzenia z informacją, że kategoria ulegla zmianie.
-    // Ale timer wyśle zdarzenie(event) jeśli od zmiany minie 500 milisekund (pół sekundy),
-    // zapobiega to zbyt szybkim i częstym uaktualnieniom tabeli z notatkami.
-    timer_->setInterval(500);
-    timer_->setSingleShot(true);
-    connect(timer_, &QTimer::timeout, [this]() {
-        if (auto item = currentItem(); item) {
-            auto const categoryID{item->data(0, IdRole).toInt()};
-            if (noteID_ != -1) {
-                EventController::instance().send(event::CategorySelected, categoryID, qi64(noteID_));
-                noteID_ = -1;
-            }
-            else {
-                EventController::instance().send(event::CategorySelected, categoryID);
-            }
-        }
-    });
-
     auto p = palette();
     p.setColor(QPalette::Base, QColor{60, 60, 60, 255});
     setAutoFillBackground(true);
@@ -89,14 +67,24 @@ CategoryTree::CategoryTree(QWidget* const parent) :
     setColumnCount(1);
     setHorizontalScrollMode(ScrollPerPixel);
 
-    connect(this, &QTreeWidget::currentItemChanged, [&](auto, auto) {
-        timer_->stop();
-        timer_->start();
+    // Dzieci kategorii są tworzone dopiero przy jej pierwszym rozwinięciu.
+    connect(this, &QTreeWidget::itemExpanded, [this](QTreeWidgetItem* const item) {
+        populate(item);
+    });
+
+    // Zmiana kategorii jest ogłaszana od razu - EventController wstrzymuje
+    // zdarzenie (debounce), więc szybkie przechodzenie po kategoriach
+    // nie uaktualnia tabeli z notatkami przy każdej z nich.
+    connect(this, &QTreeWidget::currentItemChanged, [this](QTreeWidgetItem* const item, auto) {
+        if (item) {
+            EventController::instance().publish<event::CategorySelected>(item->data(0, IdRole).toLongLong(), noteID_);
+            noteID_ = -1;
+        }
     });
 
     updateContent();
     setCurrentItem(root_);
-    EventController::instance().append(this, event::CategoryAndNoteToSelect);
+    EventController::instance().append(this, event::CategoryAndNoteToSelect, event::CategoriesChanged);
 }
 
 CategoryTree::~CategoryTree() {
@@ -105,7 +93,7 @@ CategoryTree::~CategoryTree() {
 
 void CategoryTree::
 customEvent(QEvent* const event) {
-    auto const e = dynamic_cast<Event *>(event);
+    auto const e = static_cast<Event *>(event);
     switch (int(e->type())) {
         case event::CategoryAndNoteToSelect:
             if (auto data = e->data(); data.size() == 2) {
@@ -114,17 +102,25 @@ customEvent(QEvent* const event) {
                 expandAndSelectChildFor(categoryID, noteID);
             }
             break;
+        case event::CategoriesChanged:
+            // Zmiana wprowadzona poza drzewem - budujemy je od nowa z magazynu.
+            if (generation_ != store().generation()) {
+                auto const current = currentItem();
+                auto const categoryID = current ? current->data(0, IdRole).toInt() : 0;
+                updateContent();
+                expandAndSelectChildFor(categoryID);
+            }
+            break;
     }
 }
 
-/// Utworzenie drzewa kategorii od nowa.
-/// Od nowa tzn. odczytujemy najpierw bazę danych kategorii.
+/// Utworzenie drzewa kategorii od nowa (z danych wspólnego magazynu,
+/// bez odczytu bazy danych).
 void CategoryTree::
 updateContent() noexcept {
     clear();
-
-    delete store_;
-    store_ = new StoreCategory(this);
+    items_.clear();
+    generation_ = store().generation();
 
     // Ustawiamy kategorię 'root', która jest rodzicem
     // wszystkich innych kategorii.
@@ -132,8 +128,10 @@ updateContent() noexcept {
     root_->setText(0, "Categories");
     root_->setData(0, IdRole, 0);
     root_->setData(0, PidRole, 0);
+    items_.insert(0, root_);
 
-    addItemsFor(root_);
+    // Tylko kategorie główne - pozostałe są tworzone przy rozwijaniu.
+    populate(root_);
     root_->setExpanded(true);
 }
 
@@ -176,10 +174,12 @@ newMainCategory() noexcept {
             // zapis podanej nazwy kategorii do bazy danych
             auto const childID = SQLite::instance().insert(InsertQuery, category->pid(), category->name());
             if (childID not_eq SQLite::InvalidRowid) {
-                auto expanded = fetchExpandedItems();
-                updateContent();
-                restoreExpandedItems(std::move(expanded));
-                setCurrentItem(childWithID(root_, childID));
+                // Dodajemy tylko nową kategorię (drzewo nie jest budowane od nowa).
+                category->id(childID);
+                store().add(*category);
+                generation_ = store().generation();
+                addItem(root_, *category);
+                setCurrentItem(itemWithID(childID));
             }
         }
     }
@@ -200,10 +200,12 @@ newSubcategory() noexcept {
         if (not alreadyExist(category.pid(), category.name())) {
             auto const id = SQLite::instance().insert(InsertQuery, category.pid(), category.name());
             if (id not_eq SQLite::InvalidRowid) {
-                auto expanded = fetchExpandedItems();
-                updateContent();
-                restoreExpandedItems(std::move(expanded));
-                expandAndSelectChildFor(id);
+                category.id(id);
+                store().add(category);
+                generation_ = store().generation();
+                addItem(parentItem, category);
+                parentItem->setExpanded(true);
+                setCurrentItem(itemWithID(id));
             }
         }
     }
@@ -211,7 +213,7 @@ newSubcategory() noexcept {
 
 void CategoryTree::
 expandAndSelectChildFor(i64 const categoryID, i64 const noteID) noexcept {
-    if (auto item = childWithID(root_, categoryID); item) {
+    if (auto item = itemWithID(categoryID); item) {
         // Rozwijamy parent, aby nasza kategoria była widziana.
         auto parent = item->parent();
         while (parent) {
@@ -234,26 +236,35 @@ remove_category() noexcept {
 
         // Jeśli kategoria zawiera pod-kategorje prosimy użytkownika
         // o potwierdzenie czy rzeczywiście tego chce.
-        if (store_->hasSubcategories(category.id())) {
+        if (store().hasSubcategories(category.id())) {
             QMessageBox::warning(QApplication::activeWindow(), RemoveTitle, RemoveMessage);
             return;
         }
-        // TODO check if category contains notes
+        // Notatki kategorii są usuwane razem z nią - użytkownik musi to potwierdzić.
+        if (auto const count = Category::notesCount(category.id()).value_or(0); count > 0) {
+            auto const msg = fmt::format("The category '{}' contains {} note(s).\n"
+                                         "They will be deleted together with the category. Continue?",
+                                         category.name(), count);
+            if (QMessageBox::question(QApplication::activeWindow(), DeleteTitle, QString::fromStdString(msg)) != QMessageBox::Yes)
+                return;
+        }
 
-        if (auto ok = SQLite::instance().exec(DeleteQuery, category.id()); ok) {
+        if (Category::remove(category.id())) {
             // Co by tu wybrać po usunięciu aktualnej kategorii?
-            i64 next_selected_id = 0;
+            QTreeWidgetItem* next_selected = root_;
             // Spróbuj przesunąć się do góry
             if (auto item_above = itemAbove(item); item_above && item_above != root_)
-                next_selected_id = item_above->data(0, IdRole).toInt();
+                next_selected = item_above;
             // Jeśli nie można do góry, spróbuj przesunąć się w dół.
             else if (auto item_below = itemBelow(item); item_below && item_below != root_)
-                next_selected_id = itemBelow(item)->data(0, IdRole).toInt();
-
-            auto expanded = fetchExpandedItems();
-            updateContent();
-            restoreExpandedItems(std::move(expanded));
-            setCurrentItem(childWithID(root_, next_selected_id));
+                next_selected = item_below;
+
+            store().remove(category.pid(), category.id());
+            generation_ = store().generation();
+            setCurrentItem(next_selected);
+            // Usunięcie elementu odłącza go od rodzica.
+            items_.remove(category.id());
+            delete item;
         }
     }
 }
@@ -262,14 +273,23 @@ remove_category() noexcept {
 void CategoryTree::
 editItem() noexcept {
     if (auto item = currentItem(); item) {
+        if (item == root_) return;
         if (auto opt = categoryDialog(categoryFrom(item), true); opt) {
             auto category{*opt};
             if (not alreadyExist(category.pid(), category.name())) {
                 if (SQLite::instance().update(UpdateQuery, category.name(), category.id())) {
-                    auto expanded = fetchExpandedItems();
-                    updateContent();
-                    restoreExpandedItems(std::move(expanded));
-                    setCurrentItem(childWithID(root_, category.id()));
+                    store().rename(category.pid(), category.id(), category.name());
+                    generation_ = store().generation();
+                    item->setText(0, category.qname());
+                    // Nowa nazwa - nowe miejsce wśród rodzeństwa.
+                    if (auto const parent = item->parent(); parent) {
+                        auto const expanded = expandedItems(item);
+                        parent->takeChild(parent->indexOfChild(item));
+                        insertAtStorePosition(parent, item);
+                        for (auto const e : expanded)
+                            e->setExpanded(true);
+                    }
+                    setCurrentItem(item);
                 }
             }
         }
@@ -346,27 +366,72 @@ categoryDialog(Category&& category, bool const rename) noexcept {
     return {};
 }
 
-/// Add all children (with sub-children) for passed item.
+/// Add children (without sub-children) for passed item.
+/// Children are already sorted in the store (no comparisons here).
+/// Children with subcategories show the expand indicator,
+/// their children are added when they are expanded for the first time.
 void CategoryTree::
 addItemsFor(QTreeWidgetItem* const parent) noexcept {
     auto const pid = parent->data(0, IdRole).toInt();
-    auto childs = store_->childsForParentWithID(pid);
-    std::ranges::sort(childs, [](auto const& a, auto const& b) {
-       return QString::compare(a.qname(), b.qname(), Qt::CaseInsensitive) < 0;
-    });
-    std::ranges::for_each(childs, [parent, this](auto const& category) {
-        auto const item = new QTreeWidgetItem(parent);
-        item->setText(0, category.qname());
-        item->setData(0, IdRole, category.qid());
-        item->setData(0, PidRole, category.qpid());
-        addItemsFor(item);
-    });
+    auto const& childs = store().childrenOf(pid);
+
+    QList<QTreeWidgetItem*> items{};
+    items.reserve(qsizetype(childs.size()));
+    for (auto const& category : childs) {
+        auto const item = newItem(category);
+        if (store().hasSubcategories(category.id()))
+            item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        items.push_back(item);
+    }
+    parent->addChildren(items);
+}
+
+/// Utworzenie elementów dzieci (tylko raz - przy pierwszym rozwinięciu).
+void CategoryTree::
+populate(QTreeWidgetItem* const item) noexcept {
+    if (item->data(0, PopulatedRole).toBool())
+        return;
+    item->setData(0, PopulatedRole, true);
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+    addItemsFor(item);
+}
+
+/// Element nowej kategorii (już dopisanej do 'store_') u rodzica. \n
+/// Jeśli dzieci rodzica jeszcze nie utworzono, tworzymy je wszystkie (z nową kategorią).
+void CategoryTree::
+addItem(QTreeWidgetItem* const parent, Category const& category) noexcept {
+    if (parent->data(0, PopulatedRole).toBool())
+        insertAtStorePosition(parent, newItem(category));
+    else
+        populate(parent);
+}
+
+/// Nowy element drzewa dla kategorii (jeszcze bez rodzica).
+/// Element jest dopisywany do indeksu (ID -> element).
+QTreeWidgetItem* CategoryTree::
+newItem(Category const& category) noexcept {
+    auto const item = new QTreeWidgetItem;
+    item->setText(0, category.qname());
+    item->setData(0, IdRole, category.qid());
+    item->setData(0, PidRole, category.qpid());
+    items_.insert(category.id(), item);
+    return item;
+}
+
+/// Wstawienie elementu między dzieci rodzica na pozycji kategorii
+/// w magazynie (dzieci w drzewie i w magazynie mają tę samą kolejność).
+void CategoryTree::
+insertAtStorePosition(QTreeWidgetItem* const parent, QTreeWidgetItem* const item) noexcept {
+    auto const pid = parent->data(0, IdRole).toInt();
+    auto const id = item->data(0, IdRole).toInt();
+    auto const index = store().indexOf(pid, id).value_or(parent->childCount());
+    parent->insertChild(std::min(index, parent->childCount()), item);
 }
 
 /// Sprawdzenie czy kategoria już ma podkategorię o wskazanej nazwie.
 bool CategoryTree::
 alreadyExist(i64 const pid, std::string const& name) const noexcept {
-    if (not store_->exist(pid, name))
+    if (not store().exist(pid, name))
         return {};
 
     // Podkategoria o takiej nazwie już istnieje.
@@ -378,38 +443,33 @@ alreadyExist(i64 const pid, std::string const& name) const noexcept {
 /// Zwraca tree-item kategorii ze wskazanym numer ID.
 /// Lub nullptr jesli nie znaleziono.
 QTreeWidgetItem* CategoryTree::
-childWithID(QTreeWidgetItem* const parent, i64 const id) noexcept {
-    for (auto it = QTreeWidgetItemIterator{parent}; *it; ++it) {
-        auto const item = *it;
-        i64 const item_id = item->data(0, IdRole).toInt();
-        if (item_id == id)
-            return item;
-    }
-    return nullptr;
-}
-
-/// Zwraca wektor z numerami ID aktualnie rozwiniętych kategorii.
-std::unordered_set<i64> CategoryTree::
-fetchExpandedItems() const noexcept {
-    std::unordered_set<i64> ids{};
-
-    for (auto it = QTreeWidgetItemIterator{root_}; *it; ++it) {
-        auto const item{*it};
-        if (item->isExpanded())
-            ids.insert(item->data(0, IdRole).toInt());
+itemWithID(i64 const id) noexcept {
+    if (auto const item = items_.value(id, nullptr); item)
+        return item;
+
+    // Elementu jeszcze nie ma - tworzymy dzieci kategorii na ścieżce od korzenia.
+    auto item = root_;
+    for (auto const categoryID : store().pathTo(id)) {
+        populate(item);
+        if (item = items_.value(categoryID, nullptr); not item)
+            return nullptr;
     }
-
-    return ids;
+    return item == root_ ? nullptr : item;
 }
 
-/// Rozwinicię kategorii których numery ID znajdują się we wskazanym zbiorze.
-void CategoryTree::
-restoreExpandedItems(std::unordered_set<i64>&& ids) noexcept {
-    if (not ids.empty()) {
-        for (auto it = QTreeWidgetItemIterator{root_}; *it; ++it) {
-            auto const item{*it};
-            if (ids.contains(item->data(0, IdRole).toInt()))
-                item->setExpanded(true);
-        }
+/// Rozwinięte elementy poddrzewa (wraz z elementem), ich stan
+/// jest tracony, gdy element jest przenoszony w inne miejsce.
+std::vector<QTreeWidgetItem*> CategoryTree::
+expandedItems(QTreeWidgetItem* const item) noexcept {
+    std::vector<QTreeWidgetItem*> items{};
+    std::vector<QTreeWidgetItem*> stack{item};
+    while (not stack.empty()) {
+        auto const current = stack.back();
+        stack.pop_back();
+        if (current->isExpanded())
+            items.push_back(current);
+        for (int i = 0; i < current->childCount(); ++i)
+            stack.push_back(current->child(i));
     }
+    return items;
 }
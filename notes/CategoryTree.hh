@@ -29,12 +29,12 @@
 #include "../model/StoreCategory.hh"
 #include "types.hh"
 #include <QTreeWidget>
+#include <QHash>
 #include <optional>
-#include <unordered_set>
+#include <vector>
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
-class QTimer;
 class QEvent;
 class QMouseEvent;
 class QTreeWidgetItem;
@@ -43,7 +43,7 @@ class QTreeWidgetItem;
 -------------------------------------------------------------------*/
 class CategoryTree : public QTreeWidget {
     Q_OBJECT
-    enum { IdRole = Qt::UserRole+1, PidRole};
+    enum { IdRole = Qt::UserRole+1, PidRole, PopulatedRole};
     i64 noteID_{-1};
 public:
     explicit CategoryTree(QWidget* = nullptr);
@@ -62,23 +62,37 @@ private:
     void
     addItemsFor(QTreeWidgetItem* item) noexcept;
 
+    void
+    populate(QTreeWidgetItem* item) noexcept;
+
+    void
+    addItem(QTreeWidgetItem* parent, Category const& category) noexcept;
+
+    QTreeWidgetItem*
+    newItem(Category const& category) noexcept;
+
+    static void
+    insertAtStorePosition(QTreeWidgetItem* parent, QTreeWidgetItem* item) noexcept;
+
     static Category
     categoryFrom(QTreeWidgetItem const*) noexcept;
 
     [[nodiscard]] bool
     alreadyExist(i64 pid, std::string const& name) const noexcept;
 
-    static QTreeWidgetItem*
-    childWithID(QTreeWidgetItem* parent, i64 id) noexcept;
+    [[nodiscard]] QTreeWidgetItem*
+    itemWithID(i64 id) noexcept;
 
     void
     updateContent() noexcept;
 
-    [[nodiscard]] std::unordered_set<i64>
-    fetchExpandedItems() const noexcept;
+    static std::vector<QTreeWidgetItem*>
+    expandedItems(QTreeWidgetItem* item) noexcept;
 
-    void
-    restoreExpandedItems(std::unordered_set<i64>&& ids) noexcept;
+    static StoreCategory&
+    store() noexcept {
+        return StoreCategory::instance();
+    }
 
 private slots:
     void newSubcategory() noexcept;
@@ -88,11 +102,12 @@ private slots:
 
 private:
     QTreeWidgetItem* root_{};
-    QTimer* const timer_;
-    StoreCategory* store_{};
+    // Generacja magazynu kategorii pokazywana przez drzewo.
+    u64 generation_{};
+    // Elementy drzewa wg numerów ID kategorii (0 - root).
+    QHash<i64, QTreeWidgetItem*> items_{};
 
     static std::string const InsertQuery;
-    static std::string const DeleteQuery;
     static std::string const UpdateQuery;
 public:
     static std::string const CountQuery;
@@ -6,13 +6,10 @@
 -------------------------------------------------------------------*/
 #include "CategoryTreeBrowser.hh"
 #include "../model/StoreCategory.hh"
+#include "../common/EventController.hh"
 #include <QHeaderView>
 #include <QTreeWidgetItem>
 
-/*------- forward declarations:
--------------------------------------------------------------------*/
-class StoreCategory;
-
 CategoryTreeBrowser::CategoryTreeBrowser(i64 categoryID, QWidget* const parent) :
         QTreeWidget(parent)
 {
@@ -25,8 +22,37 @@ CategoryTreeBrowser::CategoryTreeBrowser(i64 categoryID, QWidget* const parent)
     setColumnCount(1);
     setHorizontalScrollMode(ScrollPerPixel);
 
+    // Dzieci kategorii są tworzone dopiero przy jej pierwszym rozwinięciu.
+    connect(this, &QTreeWidget::itemExpanded, [this](QTreeWidgetItem* const item) {
+        populate(item);
+    });
+
     populateDialogContent();
-    if (auto item = childOfParentWithID(root_, categoryID); item) {
+    selectCategoryWithID(categoryID);
+    EventController::instance().append(this, event::CategoriesChanged);
+}
+
+CategoryTreeBrowser::~CategoryTreeBrowser() {
+    EventController::instance().remove(this);
+}
+
+void CategoryTreeBrowser::
+customEvent(QEvent* const event) {
+    auto const e = static_cast<Event *>(event);
+    switch (int(e->type())) {
+        case event::CategoriesChanged:
+            if (generation_ != StoreCategory::instance().generation()) {
+                auto const categoryID = selectedCategoryID();
+                populateDialogContent();
+                selectCategoryWithID(categoryID.value_or(0));
+            }
+            break;
+    }
+}
+
+void CategoryTreeBrowser::
+selectCategoryWithID(i64 const categoryID) noexcept {
+    if (auto item = itemWithID(categoryID); item) {
         auto parentItem = item->parent();
         while (parentItem) {
             if (not parentItem->isExpanded())
@@ -40,9 +66,10 @@ CategoryTreeBrowser::CategoryTreeBrowser(i64 categoryID, QWidget* const parent)
 void CategoryTreeBrowser::
 populateDialogContent() noexcept {
     clear();
+    items_.clear();
 
-    delete store_;
-    store_ = new StoreCategory{this};
+    // Kategorie ze wspólnego magazynu - bez odczytu bazy danych.
+    generation_ = StoreCategory::instance().generation();
 
     // Ustawiamy kategorię 'root', która jest rodzicem
     // wszystkich innych kategorii.
@@ -50,41 +77,53 @@ populateDialogContent() noexcept {
     root_->setText(0, "Categories");
     root_->setData(0, IdRole, 0);
     root_->setData(0, PidRole, 0);
+    items_.insert(0, root_);
 
-    addItemsFor(root_);
+    populate(root_);
     root_->setExpanded(true);
 }
 
 void CategoryTreeBrowser::
 addItemsFor(QTreeWidgetItem* const parent) noexcept {
     auto const pid = parent->data(0, IdRole).toInt();
-    auto childs = store_->childsForParentWithID(pid);
+    auto const& childs = StoreCategory::instance().childrenOf(pid);
 
-    // Sortowanie potomków alfabetycznie rosnąco w/g nazwy
-    std::ranges::sort(childs, [](auto const& a, auto const& b) {
-        return QString::compare(a.qname(), b.qname(), Qt::CaseInsensitive) < 0;
-    });
-
-    // Dodanie potomków do przodka w drzewie.
-    // Rekursywnie odczytujemy pod-potomków dla każdego z potomków.
-    std::ranges::for_each(childs, [parent, this](auto const& category) {
+    // Dodanie potomków do przodka w drzewie (magazyn trzyma ich już
+    // posortowanych alfabetycznie). Pod-potomkowie są dodawani
+    // przy pierwszym rozwinięciu potomka.
+    for (auto const& category : childs) {
         auto const item = new QTreeWidgetItem(parent);
         item->setText(0, category.qname());
         item->setData(0, IdRole, category.qid());
         item->setData(0, PidRole, category.qpid());
-        addItemsFor(item);
-    });
+        if (StoreCategory::instance().hasSubcategories(category.id()))
+            item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        items_.insert(category.id(), item);
+    }
+}
+
+void CategoryTreeBrowser::
+populate(QTreeWidgetItem* const item) noexcept {
+    if (item->data(0, PopulatedRole).toBool())
+        return;
+    item->setData(0, PopulatedRole, true);
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+    addItemsFor(item);
 }
 
 QTreeWidgetItem* CategoryTreeBrowser::
-childOfParentWithID(QTreeWidgetItem* parent, i64 id) noexcept {
-    for (auto it = QTreeWidgetItemIterator{parent}; *it; ++it) {
-        auto const item = *it;
-        i64 const item_id = item->data(0, IdRole).toInt();
-        if (item_id == id)
-            return item;
+itemWithID(i64 const id) noexcept {
+    if (auto const item = items_.value(id, nullptr); item)
+        return item;
+
+    // Elementu jeszcze nie ma - tworzymy dzieci kategorii na ścieżce od korzenia.
+    auto item = root_;
+    for (auto const categoryID : StoreCategory::instance().pathTo(id)) {
+        populate(item);
+        if (item = items_.value(categoryID, nullptr); not item)
+            return nullptr;
     }
-    return nullptr;
+    return item == root_ ? nullptr : item;
 }
 
 std::optional<i64> CategoryTreeBrowser::
@@ -26,27 +26,34 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include <QTreeWidget>
+#include <QHash>
 #include "../shared.hh"
 #include <optional>
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
-class StoreCategory;
+class QEvent;
 class QTreeWidgetItem;
 
 
 class CategoryTreeBrowser : public QTreeWidget {
     Q_OBJECT
-    enum { IdRole = Qt::UserRole+1, PidRole};
-    StoreCategory* store_{};
+    enum { IdRole = Qt::UserRole+1, PidRole, PopulatedRole};
+    // Generacja magazynu kategorii pokazywana przez drzewo.
+    u64 generation_{};
     QTreeWidgetItem* root_{};
+    // Elementy drzewa wg numerów ID kategorii (0 - root).
+    QHash<i64, QTreeWidgetItem*> items_{};
 public:
     explicit CategoryTreeBrowser(i64 categoryID, QWidget* = nullptr);
-    ~CategoryTreeBrowser() override = default;
+    ~CategoryTreeBrowser() override;
     std::optional<i64> selectedCategoryID() const noexcept;
 
 private:
+    void customEvent(QEvent*) override;
     void populateDialogContent() noexcept;
+    void selectCategoryWithID(i64 categoryID) noexcept;
     void addItemsFor(QTreeWidgetItem* item) noexcept;
-    static QTreeWidgetItem* childOfParentWithID(QTreeWidgetItem* parent, i64 id) noexcept;
+    void populate(QTreeWidgetItem* item) noexcept;
+    [[nodiscard]] QTreeWidgetItem* itemWithID(i64 id) noexcept;
 };
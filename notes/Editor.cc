@@ -61,7 +61,7 @@ Editor::~Editor() {
 }
 
 void Editor::customEvent(QEvent* const event) {
-    auto const e = dynamic_cast<Event*>(event);
+    auto const e = static_cast<Event*>(event);
     switch (int(e->type())) {
         case event::SelectFontRequest:
             select_font();
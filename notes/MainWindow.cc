@@ -28,7 +28,9 @@
 #include "Settings.hh"
 #include "NotesWorkspace.hh"
 #include "CategoryTree.hh"
+#include "../common/EventStats.hh"
 #include <QApplication>
+#include <QShortcut>
 #include <QSplitter>
 #include <fmt/core.h>
 
@@ -45,6 +47,12 @@ MainWindow::MainWindow(QWidget *const parent) :
     splitter_->addWidget(new CategoryTree);
     splitter_->addWidget(new NotesWorkspace);
     setCentralWidget(splitter_);
+
+    // Statystyki opóźnień zdarzeń na żądanie (program uruchomiony z --event-stats).
+    if (EventStats::instance().enabled())
+        connect(new QShortcut(QKeySequence("Ctrl+Shift+F12"), this), &QShortcut::activated, this, [] {
+            EventStats::instance().dump();
+        });
 }
 
 /// Wyświetlenie okna programu - odczyt i zastosowanie zapamiętanej
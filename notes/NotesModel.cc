@@ -0,0 +1,214 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "NotesModel.hh"
+#include <algorithm>
+
+NotesModel::NotesModel(QObject* const parent) :
+        QAbstractTableModel(parent)
+{}
+
+void NotesModel::
+reset(NotesListing listing) noexcept {
+    beginResetModel();
+    ids_ = std::move(listing.noteIDs);
+    rows_.clear();
+    rows_.reserve(std::min<std::size_t>(ids_.size(), FetchSize));
+    tips_.clear();
+    rebuildIndex();
+    endResetModel();
+}
+
+void NotesModel::
+reset(std::vector<SearchHit> hits) noexcept {
+    beginResetModel();
+    ids_.clear();
+    rows_.clear();
+    tips_.clear();
+    ids_.reserve(hits.size());
+    rows_.reserve(hits.size());
+    tips_.reserve(hits.size());
+    // Wyników wyszukiwania jest niewiele (limit) - wszystkie są od razu w modelu.
+    for (auto& hit : hits) {
+        ids_.push_back(hit.id);
+        rows_.push_back(NoteHeader{
+            .id = hit.id,
+            .pid = hit.pid,
+            .title = std::move(hit.title),
+            .description = std::move(hit.description),
+            .category = std::move(hit.category)
+        });
+        tips_.push_back(std::move(hit.snippet));
+    }
+    rebuildIndex();
+    endResetModel();
+}
+
+int NotesModel::
+rowCount(QModelIndex const& parent) const {
+    return parent.isValid() ? 0 : int(rows_.size());
+}
+
+int NotesModel::
+columnCount(QModelIndex const& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant NotesModel::
+data(QModelIndex const& index, int const role) const {
+    auto const h = header(index.row());
+    if (not h)
+        return {};
+
+    switch (role) {
+        case Qt::DisplayRole:
+            switch (index.column()) {
+                case TitleColumn: return h->qtitle();
+                case DescriptionColumn: return h->qdescription();
+                case CategoryColumn: return h->qcategory();
+            }
+            break;
+        case Qt::ToolTipRole:
+            if (not tips_.empty())
+                return QString("<b>%1</b><br>%2").arg(h->qtitle().toHtmlEscaped(),
+                                                      QString::fromStdString(tips_[std::size_t(index.row())]));
+            break;
+        case NoteID:
+            return qi64(h->id);
+        case CategoryID:
+            return qi64(h->pid);
+    }
+    return {};
+}
+
+QVariant NotesModel::
+headerData(int const section, Qt::Orientation const orientation, int const role) const {
+    if (role != Qt::DisplayRole or orientation != Qt::Horizontal)
+        return {};
+    switch (section) {
+        case TitleColumn: return "Title";
+        case DescriptionColumn: return "Description";
+        case CategoryColumn: return "Category";
+    }
+    return {};
+}
+
+bool NotesModel::
+canFetchMore(QModelIndex const& parent) const {
+    return not parent.isValid() and rows_.size() < ids_.size();
+}
+
+/// Odczyt nagłówków kolejnego okna notatek (jedno zapytanie na okno).
+void NotesModel::
+fetchMore(QModelIndex const& parent) {
+    if (parent.isValid())
+        return;
+
+    auto const first = rows_.size();
+    auto const last = std::min(first + FetchSize, ids_.size());
+    if (first >= last)
+        return;
+
+    std::vector<i64> window(ids_.begin() + long(first), ids_.begin() + long(last));
+    auto headers = Note::headersWithIDs(window);
+
+    // Zapytanie zwraca wiersze w dowolnej kolejności - układamy je wg listy.
+    std::unordered_map<i64, std::size_t> positions{};
+    positions.reserve(headers.size());
+    for (std::size_t i = 0; i < headers.size(); ++i)
+        positions.emplace(headers[i].id, i);
+
+    beginInsertRows({}, int(first), int(last) - 1);
+    for (auto const id : window) {
+        if (auto const it = positions.find(id); it != positions.end())
+            rows_.push_back(std::move(headers[it->second]));
+        else
+            // Notatka usunięta w międzyczasie - wiersz zostaje (pusty) do następnego odświeżenia.
+            rows_.push_back(NoteHeader{.id = id});
+    }
+    endInsertRows();
+}
+
+NoteHeader const* NotesModel::
+header(int const row) const noexcept {
+    if (row < 0 or std::size_t(row) >= rows_.size())
+        return nullptr;
+    return &rows_[std::size_t(row)];
+}
+
+bool NotesModel::
+fetchRow(int const row) noexcept {
+    if (row < 0 or std::size_t(row) >= ids_.size())
+        return false;
+    while (rows_.size() <= std::size_t(row))
+        fetchMore({});
+    return true;
+}
+
+std::optional<int> NotesModel::
+rowWithID(i64 const noteID) noexcept {
+    auto const it = index_.find(noteID);
+    if (it == index_.end() or not fetchRow(it->second))
+        return {};
+    return it->second;
+}
+
+bool NotesModel::
+removeNote(i64 const noteID) noexcept {
+    auto const it = index_.find(noteID);
+    if (it == index_.end())
+        return false;
+
+    auto const row = it->second;
+    auto const fetched = std::size_t(row) < rows_.size();
+    if (fetched)
+        beginRemoveRows({}, row, row);
+
+    ids_.erase(ids_.begin() + row);
+    if (fetched)
+        rows_.erase(rows_.begin() + row);
+    if (std::size_t(row) < tips_.size())
+        tips_.erase(tips_.begin() + row);
+
+    // Wiersze poniżej przesuwają się o jeden w górę.
+    index_.erase(it);
+    for (auto i = std::size_t(row); i < ids_.size(); ++i)
+        index_[ids_[i]] = int(i);
+
+    if (fetched)
+        endRemoveRows();
+    return true;
+}
+
+/// Nowy nagłówek notatki w jej wierszu. \n
+/// Lista jest w kolejności tytułów - gdy tytuł się zmienił (lub wiersz nie
+/// był jeszcze odczytany i nie wiadomo, czy się zmienił), miejsce notatki
+/// na liście może być inne i listę trzeba odczytać od nowa.
+bool NotesModel::
+refreshNote(i64 const noteID) noexcept {
+    auto const it = index_.find(noteID);
+    if (it == index_.end())
+        return false;
+
+    auto const row = std::size_t(it->second);
+    if (row >= rows_.size())
+        return false;
+
+    auto headers = Note::headersWithIDs({noteID});
+    if (headers.empty() or headers.front().title != rows_[row].title)
+        return false;
+    rows_[row] = std::move(headers.front());
+    emit dataChanged(index(int(row), 0), index(int(row), ColumnCount - 1));
+    return true;
+}
+
+void NotesModel::
+rebuildIndex() noexcept {
+    index_.clear();
+    index_.reserve(ids_.size());
+    for (std::size_t i = 0; i < ids_.size(); ++i)
+        index_.emplace(ids_[i], int(i));
+}
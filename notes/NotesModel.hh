@@ -0,0 +1,87 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared.hh"
+#include "../model/note.hh"
+#include <QAbstractTableModel>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*------- types:
+-------------------------------------------------------------------*/
+/// Notes of the categories (in order of titles). \n
+/// The request is prepared in the GUI thread, the IDs of notes
+/// can be read in any thread (see read()).
+struct NotesListing {
+    std::vector<i64> categoryIDs{};
+    std::vector<i64> noteIDs{};
+
+    /// Read the IDs of notes from the database.
+    void read() noexcept {
+        noteIDs = Note::idsInCategories(categoryIDs);
+    }
+};
+
+/*------- class:
+-------------------------------------------------------------------*/
+/// Model of the notes table. \n
+/// The listing is a vector of note IDs (cheap even for tens of thousands
+/// of notes); headers of notes are read in windows of 'FetchSize' rows
+/// when the view scrolls to them (canFetchMore/fetchMore). \n
+/// Rows of notes are found by ID in constant time - the index (note ID -> row)
+/// is kept up to date when the listing is loaded or a note is removed.
+class NotesModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum { NoteID = Qt::UserRole + 1, CategoryID };
+    enum { TitleColumn, DescriptionColumn, CategoryColumn, ColumnCount };
+    static constexpr int FetchSize = 256;
+
+    explicit NotesModel(QObject* = nullptr);
+    ~NotesModel() override = default;
+
+    /// New listing - notes already read (e.g. in the database thread).
+    void reset(NotesListing listing) noexcept;
+    /// New listing - results of the full-text search (snippets are tooltips).
+    void reset(std::vector<SearchHit> hits) noexcept;
+
+    [[nodiscard]] int rowCount(QModelIndex const& parent = {}) const override;
+    [[nodiscard]] int columnCount(QModelIndex const& parent = {}) const override;
+    [[nodiscard]] QVariant data(QModelIndex const& index, int role) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    [[nodiscard]] bool canFetchMore(QModelIndex const& parent) const override;
+    void fetchMore(QModelIndex const& parent) override;
+
+    /// Number of notes of the listing (fetched or not).
+    [[nodiscard]] int size() const noexcept { return int(ids_.size()); }
+    /// Fetch headers up to the row. \return false if there is no such row.
+    bool fetchRow(int row) noexcept;
+    /// Header of the note in the row (nullptr for invalid row).
+    [[nodiscard]] NoteHeader const* header(int row) const noexcept;
+    /// Row of the note (headers are fetched up to this row if necessary).
+    [[nodiscard]] std::optional<int> rowWithID(i64 noteID) noexcept;
+    /// Is the note in the listing (without fetching)?
+    [[nodiscard]] bool contains(i64 const noteID) const noexcept { return index_.contains(noteID); }
+
+    /// Remove the row of the note (e.g. after deleting the note).
+    bool removeNote(i64 noteID) noexcept;
+    /// Read the header of the note again (e.g. after editing the note).
+    /// \return false if the row could not be updated in place (the note is not
+    ///     listed, or its title changed so its position may differ) - the
+    ///     listing must be read again.
+    bool refreshNote(i64 noteID) noexcept;
+
+private:
+    void rebuildIndex() noexcept;
+
+    std::unordered_map<i64, int> index_{};  // note ID -> row
+    std::vector<i64> ids_{};            // all notes of the listing
+    std::vector<NoteHeader> rows_{};    // fetched headers, rows_[i].id == ids_[i]
+    std::vector<std::string> tips_{};   // search snippets (empty for category listing)
+};
@@ -25,49 +25,56 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "NotesTable.hh"
+#include "NotesModel.hh"
 #include "DeleteNoteDialog.hh"
 #include "TreeDialog.hh"
 #include "../model/note.hh"
+#include "../sqlite/sqlite.hh"
 #include "../model/category.hh"
 #include "../common/EventController.hh"
-#include <QTableWidgetItem>
+#include "../common/DatabaseExecutor.hh"
 #include <QDialog>
 #include <QHeaderView>
 #include <QMessageBox>
+#include <algorithm>
 #include <fmt/core.h>
 
 NotesTable::NotesTable(QWidget* const parent) :
-        QTableWidget(parent)
+        QTableView(parent),
+        model_{new NotesModel(this)}
 {
-    setRowCount(0);
-    setColumnCount(COLUMN_COUNT);
+    setModel(model_);
     setEditTriggers(NoEditTriggers);
     setSelectionBehavior(SelectRows);
+    setSelectionMode(SingleSelection);
+    setWordWrap(false);
 
-    setHorizontalHeaderItem(0, new QTableWidgetItem("Title"));
-    setHorizontalHeaderItem(1, new QTableWidgetItem("Description"));
-    setHorizontalHeaderItem(2, new QTableWidgetItem("Category"));
+    // Wszystkie wiersze mają tę samą wysokość - widok nie mierzy każdego z nich.
+    verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    verticalHeader()->setDefaultSectionSize(fontMetrics().height() + 8);
+    horizontalHeader()->setSectionResizeMode(NotesModel::TitleColumn, QHeaderView::Stretch);
 
     EventController::instance().append(this,
                                        event::CategorySelected,
                                        event::RemoveCurrentNoteRequest,
                                        event::MoveCurrentNoteRequest,
-                                       event::NoteDatabaseChanged);
+                                       event::NoteDatabaseChanged,
+                                       event::SearchRequest,
+                                       event::NotesListingLoaded,
+                                       event::SearchResultsLoaded);
 
 
     // Użytkownik wybrał nowy wiersz.
-    connect(this, &QTableWidget::currentItemChanged, [&] (QTableWidgetItem* const currentItem, auto){
-        if (currentItem) {
-            if (auto noteID = currentItem->data(NoteID); noteID.canConvert<int>())
-                EventController::instance().send(event::NoteSelected, noteID.toInt());
+    connect(selectionModel(), &QItemSelectionModel::currentRowChanged, [this] (QModelIndex const& current, auto) {
+        if (auto const header = model_->header(current.row()); header) {
+            currentNoteID_ = header->id;
+            EventController::instance().publish<event::NoteSelected>(header->id);
         }
     });
     // Użytkownik dwa razy kliknął myszką wiersz.
-    connect(this, &QTableWidget::cellDoubleClicked, [&] (auto const row, auto const col){
-        if (auto selected_item = item(row, 0); selected_item) {
-            auto noteID = selected_item->data(NoteID).toInt();
-            EventController::instance().send(event::EditNoteRequest, noteID);
-        }
+    connect(this, &QTableView::doubleClicked, [this] (QModelIndex const& index) {
+        if (auto const header = model_->header(index.row()); header)
+            EventController::instance().send(event::EditNoteRequest, qi64(header->id));
     });
 }
 
@@ -76,45 +83,62 @@ NotesTable::~NotesTable() {
 }
 
 void NotesTable::customEvent(QEvent* const event) {
-    auto const e = dynamic_cast<Event *>(event);
+    auto const e = static_cast<Event *>(event);
     switch (int(e->type())) {
         case event::CategorySelected:
-            clearContent();
-            if (auto data = e->data(); not data.empty()) {
-                auto const categoryID{data[0].toInt()};
-                updateContentForCategoryWithID(categoryID);
-                if (data.size() == 2) {
-                    auto const noteID{data[1].toInt()};
-                    if (auto item = rowWithID(noteID); item)
-                        setCurrentItem(item);
-                }
-                else
-                    selectRow(0);
+            {
+                auto const& payload = e->payload<event::CategorySelected>();
+                updateContentForCategoryWithID(payload.categoryID, payload.noteID);
             }
             break;
         case event::NoteDatabaseChanged:
-            clearContent();
             if (auto data = e->data(); data.size() == 2) {
-                updateContentForCategoryWithID(data[0].toInt());
-                auto noteID = data[1].toInt();
-                if (auto item = rowWithID(noteID); item)
-                    setCurrentItem(item);
+                auto const noteID{data[1].toInt()};
+                // Notatka z listy - uaktualniamy tylko jej wiersz.
+                if (model_->refreshNote(noteID)) {
+                    auto const current = (noteID == currentNoteID_);
+                    selectNoteWithID(noteID);
+                    // Ten sam wiersz nie zmienia bieżącego wiersza (nie ma currentRowChanged),
+                    // a przeglądarka musi odczytać nową treść notatki.
+                    if (current)
+                        EventController::instance().publish<event::NoteSelected>(noteID);
+                }
+                else
+                    updateContentForCategoryWithID(data[0].toInt(), noteID);
             }
             break;
-        case event::RemoveCurrentNoteRequest:
-            if (auto current_item = item(currentRow(), 0); current_item) {
-                auto noteID = current_item->data(NoteID).toInt();
-                deleteNoteWithID(noteID);
+        case event::SearchRequest:
+            if (auto data = e->data(); not data.empty())
+                updateContentForSearch(data[0].toString());
+            break;
+        case event::NotesListingLoaded:
+            // Wynik ostatniego zlecenia (starsze są pomijane).
+            if (auto data = e->data(); data.size() == 2 and u64(data[0].toLongLong()) == pending_) {
+                model_->reset(data[1].value<NotesListing>());
+                estimateColumnWidths();
+                if (auto const row = model_->rowWithID(selectAfterLoad_); row)
+                    selectRowAt(*row);
+                else
+                    selectRowAt(0);
             }
             break;
+        case event::SearchResultsLoaded:
+            if (auto data = e->data(); data.size() == 2 and u64(data[0].toLongLong()) == pending_) {
+                model_->reset(data[1].value<std::vector<SearchHit>>());
+                estimateColumnWidths();
+                selectRowAt(0);
+            }
+            break;
+        case event::RemoveCurrentNoteRequest:
+            if (auto const header = model_->header(currentIndex().row()); header)
+                deleteNoteWithID(header->id);
+            break;
         case event::MoveCurrentNoteRequest:
-            if (auto item = currentItemWhenFocus(); item) {
-                if (auto data = dataFromItem(item); data) {
-                    auto [categoryID, noteID] = *data;
-                    auto dialog = new TreeDialog(categoryID);
-                    if (dialog->exec() == QDialog::Accepted) {
-                        moveNoteToCategoryWithID(noteID, dialog->selectedCategoryID());
-                    }
+            if (auto const header = currentHeaderWhenFocus(); header) {
+                auto const noteID = header->id;
+                auto dialog = new TreeDialog(header->pid);
+                if (dialog->exec() == QDialog::Accepted) {
+                    moveNoteToCategoryWithID(noteID, dialog->selectedCategoryID());
                 }
             }
             break;
@@ -123,50 +147,77 @@ void NotesTable::customEvent(QEvent* const event) {
 
 
 /// Wyświetlamy wszystkie notatki dla wskazanej kategorii
-/// oraz wszystkich jej podkategorii (jeśli istnieją).
+/// oraz wszystkich jej podkategorii (jeśli istnieją). \n
+/// Lista jest odczytywana w wątku bazy danych, tabela jest
+/// uaktualniana po nadejściu wyniku (NotesListingLoaded).
 void NotesTable::
-updateContentForCategoryWithID(i64 const categoryID) noexcept {
-    // Usunięcie wszystkich wierszy w tabeli.
-    clearContent();
-
-    if (auto ids = Category::idsSubchainFor(categoryID); not ids.empty()) {
-        if (auto notes = Note::notes(std::move(ids)); not notes.empty()) {
-            setRowCount(int(notes.size()));
-            auto row = 0;
-            for (auto const& note : notes) {
-                auto const item0 = new QTableWidgetItem(note.qtitle());
-                setItem(row, 0, item0);
-                item0->setData(NoteID, note.id<qi64>());
-                item0->setData(CategoryID, note.pid<qi64>());
-
-                auto const item1 = new QTableWidgetItem(note.qdescription());
-                setItem(row, 1, item1);
-
-                auto const item2 = new QTableWidgetItem(note.qcategory());
-                setItem(row, 2, item2);
-
-                ++row;
-            }
-        }
-    }
-    horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-    resizeColumnToContents(1);
-    resizeColumnToContents(2);
-//    horizontalHeader()->setSectionResizeMode(1, QHeaderView::Interactive);
+updateContentForCategoryWithID(i64 const categoryID, i64 const noteID) noexcept {
     categoryID_ = categoryID;
+    selectAfterLoad_ = noteID;
+    // Odczytujemy tylko numery ID notatek, nagłówki model pobiera
+    // oknami, gdy widok ich potrzebuje.
+    NotesListing listing{.categoryIDs = Category::idsSubchainFor(categoryID)};
+    pending_ = DatabaseExecutor::instance().post(event::NotesListingLoaded, [listing = std::move(listing)]() mutable {
+        listing.read();
+        return listing;
+    });
+}
 
-    update();
+void NotesTable::
+updateContentForSearch(QString const& text) noexcept {
+    if (text.isEmpty()) {
+        updateContentForCategoryWithID(categoryID_);
+        return;
+    }
+    pending_ = DatabaseExecutor::instance().post(event::SearchResultsLoaded, [text = text.toStdString()] {
+        return Note::search(text);
+    });
 }
 
-QTableWidgetItem* NotesTable::
-rowWithID(qint64 id) const noexcept {
-    int const rows = model()->rowCount();
-    for (int i = 0; i < rows; ++i) {
-        auto const row = item(i, 0);
-        if (row->data(NoteID).toInt() == id)
-            return row;
+void NotesTable::
+estimateColumnWidths() noexcept {
+    // Pierwsze okno nagłówków (wystarczy na próbkę).
+    if (model_->rowCount() == 0 and model_->canFetchMore({}))
+        model_->fetchMore({});
+
+    auto const fm = fontMetrics();
+    auto const rows = std::min(model_->rowCount(), WIDTH_SAMPLE);
+    auto const padding = 2 * fm.averageCharWidth() + 8;
+    auto const maxWidth = std::max(viewport()->width() / 3, 120);
+
+    for (auto const column : {int(NotesModel::DescriptionColumn), int(NotesModel::CategoryColumn)}) {
+        auto width = horizontalHeader()->sectionSizeHint(column);
+        for (int row = 0; row < rows; ++row)
+            width = std::max(width, fm.horizontalAdvance(model_->index(row, column).data().toString()) + padding);
+        setColumnWidth(column, std::min(width, maxWidth));
     }
-    return nullptr;
+}
+
+/// Wybranie wiersza (nagłówki są pobierane do tego wiersza, jeśli trzeba).
+void NotesTable::
+selectRowAt(int const row) noexcept {
+    if (model_->fetchRow(row)) {
+        selectRow(row);
+        scrollTo(model_->index(row, 0));
+    }
+}
+
+void NotesTable::
+selectNoteWithID(i64 const noteID) noexcept {
+    if (auto const row = model_->rowWithID(noteID); row)
+        selectRowAt(*row);
+}
+
+std::optional<int> NotesTable::
+rowWithID(i64 const noteID) noexcept {
+    return model_->rowWithID(noteID);
+}
+
+NoteHeader const* NotesTable::
+currentHeaderWhenFocus() const noexcept {
+    if (hasFocus())
+        return model_->header(currentIndex().row());
+    return {};
 }
 
 void NotesTable::
@@ -174,14 +225,14 @@ deleteNoteWithID(qi64 const noteID) noexcept {
     if (auto note = Note::withID(noteID); note) {
         auto dialog = std::make_unique<DeleteNoteDialog>(*note, this);
         if (dialog->exec() == QDialog::Accepted) {
-            auto row_nr = currentRow();
+            auto row_nr = currentIndex().row();
             if (Note::remove(noteID)) {
-                updateContentForCategoryWithID(categoryID_);
+                model_->removeNote(noteID);
                 // Wybieramy wiersz o takim samym indeksie jeśli jest taki.
                 // Lub ostatni wiersz.
-                if (row_nr >= rowCount())
-                    row_nr = rowCount() - 1;
-                selectRow(row_nr);
+                if (row_nr >= model_->size())
+                    row_nr = model_->size() - 1;
+                selectRowAt(row_nr);
             }
         }
     }
@@ -190,14 +241,18 @@ deleteNoteWithID(qi64 const noteID) noexcept {
 void NotesTable::
 moveNoteToCategoryWithID(i64 noteID, i64 destinationCategoryID) noexcept {
     if (auto note = Note::withID(noteID); note) {
+        // Sprawdzenie tytułu i zapis w jednej transakcji.
+        auto transaction = SQLite::instance().transaction();
         // Nowa kategoria nie może już zawierać notatki o takim samym tytule.
         if (Note::containsParentTheNoteWithTitle(destinationCategoryID, (*note).title())) {
+            transaction.rollback();
             QMessageBox::critical(this, "Illegal note title.", "The selected category already contains a note with this title.");
             return;
         }
         // Błąd zapisu do bazy danych.
         note->pid(destinationCategoryID);
-        if (not note->save()) {
+        if (not transaction or not note->save() or not transaction.commit()) {
+            transaction.rollback();
             QMessageBox::critical(this, "Database error", "Error updating note in database.");
             return;
         }
@@ -27,28 +27,35 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "../shared.hh"
-#include <QTableWidget>
+#include <QTableView>
 #include <optional>
-#include <utility>
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
 class QEvent;
-
-class QTableWidgetItem;
+class NotesModel;
+struct NoteHeader;
 
 /*------- class:
 -------------------------------------------------------------------*/
-class NotesTable : public QTableWidget {
+class NotesTable : public QTableView {
     Q_OBJECT
-    enum { NoteID = Qt::UserRole + 1, CategoryID };
-    static constexpr int COLUMN_COUNT = 3;
+    /// Liczba wierszy, na podstawie których szacowana jest szerokość kolumn.
+    static constexpr int WIDTH_SAMPLE = 64;
     i64 categoryID_{};
+    i64 currentNoteID_{};
+    // Ostatnie zlecenie wątku bazy danych i notatka do wybrania po jego wykonaniu.
+    u64 pending_{};
+    i64 selectAfterLoad_{-1};
+    NotesModel* const model_;
 public:
     explicit NotesTable(QWidget * = nullptr);
 
     ~NotesTable() override;
 
+    /// Numer wiersza notatki (bez przeglądania wszystkich wierszy).
+    [[nodiscard]] std::optional<int> rowWithID(i64 noteID) noexcept;
+
 private:
     /// Odbieranie zdefiniowanych w programie zdarzeń.
     /// \param event - zdarzenie
@@ -57,35 +64,21 @@ private:
     void deleteNoteWithID(qi64 noteID) noexcept;
 
     /// Uaktualnienie tabeli notatek dla wskazanej kategorii.
-    /// \param id - numer ID kategorii, której notatki mają być wyświetlone.
-    void updateContentForCategoryWithID(i64 id) noexcept;
-
-    void clearContent() noexcept {
-        clearContents();
-        setRowCount(0);
-    }
-
-    [[nodiscard]] QTableWidgetItem* currentItemWhenFocus() const noexcept {
-        if (hasFocus())
-            return item(currentRow(), 0);
-        return {};
-    }
+    /// \param id - numer ID kategorii, której notatki mają być wyświetlone,
+    /// \param noteID - notatka do wybrania (-1 - pierwszy wiersz).
+    void updateContentForCategoryWithID(i64 id, i64 noteID = -1) noexcept;
 
-    static std::optional<std::pair<i64, i64>>
-    dataFromItem(QTableWidgetItem *const item) noexcept {
-        i64 noteID{-1}, categoryID{-1};
+    /// Wyświetlenie notatek znalezionych przez wyszukiwanie pełnotekstowe.
+    /// \param text - szukany tekst (pusty - powrót do notatek bieżącej kategorii).
+    void updateContentForSearch(QString const& text) noexcept;
 
-        if (auto data = item->data(CategoryID); data.isValid() && data.canConvert<int>())
-            categoryID = data.toInt();
-        if (auto data = item->data(NoteID); data.isValid() && data.canConvert<int>())
-            noteID = data.toInt();
+    /// Szerokość kolumn szacowana na podstawie próbki wierszy (nie wszystkich).
+    void estimateColumnWidths() noexcept;
 
-        if (noteID not_eq -1 and categoryID not_eq -1)
-            return std::make_pair(categoryID, noteID);
-        return {};
-    }
+    void selectRowAt(int row) noexcept;
+    void selectNoteWithID(i64 noteID) noexcept;
 
-    [[nodiscard]] QTableWidgetItem* rowWithID(qint64 id) const noexcept;
+    [[nodiscard]] NoteHeader const* currentHeaderWhenFocus() const noexcept;
 
     void moveNoteToCategoryWithID(i64 noteID, i64 destinationCategoryID) noexcept;
 };
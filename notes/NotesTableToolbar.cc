@@ -30,13 +30,16 @@
 #include <QAction>
 #include <QIcon>
 #include <QLabel>
+#include <QLineEdit>
+#include <QSignalBlocker>
 #include <fmt/core.h>
 
 
 NotesTableToolbar::NotesTableToolbar(QWidget* const parent) :
     QToolBar(parent),
     categoryChain_{},
-    categoryChainLabel_{new QLabel}
+    categoryChainLabel_{new QLabel},
+    searchEdit_{new QLineEdit}
 {
     // https://specifications.freedesktop.org/icon-naming-spec/icon-naming-spec-latest.html
 
@@ -58,6 +61,12 @@ NotesTableToolbar::NotesTableToolbar(QWidget* const parent) :
     spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     addWidget(spacer);
 
+    searchEdit_->setPlaceholderText("Search");
+    searchEdit_->setClearButtonEnabled(true);
+    searchEdit_->setToolTip("Search notes (title, description and content)");
+    searchEdit_->setMaximumWidth(240);
+    addWidget(searchEdit_);
+
     addAction(newAction);
     addAction(edtAction);
     addAction(delAction);
@@ -81,15 +90,35 @@ NotesTableToolbar::NotesTableToolbar(QWidget* const parent) :
         EventController::instance().send(event::MoveCurrentNoteRequest);
     });
 
-    EventController::instance().append(this, event::CategorySelected);
+    // Użytkownik zatwierdził szukany tekst.
+    connect(searchEdit_, &QLineEdit::returnPressed, [this] {
+        EventController::instance().send(event::SearchRequest, searchEdit_->text().trimmed());
+    });
+    // Wyczyszczenie pola - powrót do notatek bieżącej kategorii.
+    connect(searchEdit_, &QLineEdit::textChanged, [](QString const& text) {
+        if (text.isEmpty())
+            EventController::instance().send(event::SearchRequest, QString{});
+    });
+
+    EventController::instance().append(this, event::CategorySelected, event::CategoriesChanged);
 }
 
 void NotesTableToolbar::customEvent(QEvent* const event) {
-    auto const e = dynamic_cast<Event *>(event);
+    auto const e = static_cast<Event *>(event);
     switch (int(e->type())) {
         case event::CategorySelected:
-            if (auto data = e->data(); not data.empty()) {
-                currentCategoryID_ = data[0].toInt();
+            {
+                currentCategoryID_ = e->payload<event::CategorySelected>().categoryID;
+                categoryChain_ = Tools::categoriesChainInfo(currentCategoryID_);
+                categoryChainLabel_->setText(qstr::fromStdString(*categoryChain_));
+                // Tabela pokazuje teraz notatki kategorii, nie wyniki wyszukiwania.
+                QSignalBlocker const blocker{searchEdit_};
+                searchEdit_->clear();
+            }
+            break;
+        case event::CategoriesChanged:
+            // Nazwa bieżącej kategorii (lub jej przodka) mogła się zmienić.
+            if (currentCategoryID_ > 0) {
                 categoryChain_ = Tools::categoriesChainInfo(currentCategoryID_);
                 categoryChainLabel_->setText(qstr::fromStdString(*categoryChain_));
             }
@@ -32,6 +32,7 @@
 /*------- forward declarations:
 -------------------------------------------------------------------*/
 class QLabel;
+class QLineEdit;
 class QEvent;
 
 /*------- class:
@@ -46,5 +47,6 @@ private:
     void customEvent(QEvent*) override;
     std::optional<std::string> categoryChain_;
     QLabel* const categoryChainLabel_;
+    QLineEdit* const searchEdit_;
     i64 currentCategoryID_{};
 };
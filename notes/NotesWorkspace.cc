@@ -72,7 +72,7 @@ void NotesWorkspace::showEvent(QShowEvent *const event) {
 
 void NotesWorkspace::customEvent(QEvent* const event) {
     event->accept();
-    auto const e = dynamic_cast<Event*>(event);
+    auto const e = static_cast<Event*>(event);
 
     switch (static_cast<int>(e->type())) {
         case event::NewNoteRequest:
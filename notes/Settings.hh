@@ -40,6 +40,15 @@ namespace settings {
     static int const MAJOR_APP_VERSION = 0;
     static int const MINOR_APP_VERSION = 1;
     static int const PATCH_APP_VERSION = 0;
+    // Baza danych (klucze w ustawieniach: Database/...).
+    static inline char const* const DATABASE_WAL_KEY = "Database/WAL";
+    static inline char const* const DATABASE_BUSY_TIMEOUT_KEY = "Database/BusyTimeout";
+    static inline char const* const DATABASE_READERS_KEY = "Database/Readers";
+    static bool const DEFAULT_DATABASE_WAL = true;
+    static int const DEFAULT_DATABASE_BUSY_TIMEOUT = 5000;  // ms
+    static int const DEFAULT_DATABASE_READERS = 2;
+    // Strefa czasowa dat (np. "Europe/Warsaw"), domyślnie DateTime::DefaultZone.
+    static inline char const* const DATETIME_ZONE_KEY = "DateTime/TimeZone";
 
     static inline std::string appVersion() noexcept {
         return fmt::format("{}.{}.{}", MAJOR_APP_VERSION, MINOR_APP_VERSION, PATCH_APP_VERSION);
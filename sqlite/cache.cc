@@ -0,0 +1,80 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+#include "cache.hh"
+
+// Take the statement from the cache or prepare a new one.
+sqlite3_stmt* StmtCache::acquire(sqlite3* const db, std::string_view const sql) noexcept {
+    if (auto it = index_.find(sql); it != index_.end()) {
+        auto const entry = it->second;
+        if (not entry->busy) {
+            ++hits_;
+            entry->busy = true;
+            lru_.splice(lru_.begin(), lru_, entry);
+            return entry->stmt;
+        }
+    }
+
+    ++misses_;
+    sqlite3_stmt* stmt{};
+    if (SQLITE_OK not_eq sqlite3_prepare_v2(db, sql.data(), static_cast<int>(sql.size()), &stmt, nullptr)) {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+    // The same text is already in use (re-entrant call) - the new statement
+    // is not cached and will be finalized on release.
+    if (capacity_ == 0 or index_.contains(sql))
+        return stmt;
+
+    lru_.push_front(Entry{std::string{sql}, stmt, true});
+    index_.emplace(lru_.front().sql, lru_.begin());
+    evict();
+    return stmt;
+}
+
+// Give the statement back to the cache.
+void StmtCache::release(std::string_view const sql, sqlite3_stmt* const stmt) noexcept {
+    if (stmt == nullptr)
+        return;
+
+    if (auto it = index_.find(sql); it != index_.end() and it->second->stmt == stmt) {
+        // An error of the last step is reported by reset - it was already logged.
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        it->second->busy = false;
+        evict();
+        return;
+    }
+    sqlite3_finalize(stmt);
+}
+
+void StmtCache::clear() noexcept {
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->busy) {
+            ++it;
+            continue;
+        }
+        index_.erase(it->sql);
+        sqlite3_finalize(it->stmt);
+        it = lru_.erase(it);
+    }
+}
+
+void StmtCache::capacity(std::size_t const n) noexcept {
+    capacity_ = n;
+    evict();
+}
+
+// Remove the least recently used idle statements above the capacity.
+void StmtCache::evict() noexcept {
+    auto it = lru_.end();
+    while (lru_.size() > capacity_ and it != lru_.begin()) {
+        --it;
+        if (it->busy)
+            continue;
+        index_.erase(it->sql);
+        sqlite3_finalize(it->stmt);
+        it = lru_.erase(it);
+    }
+}
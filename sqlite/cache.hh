@@ -0,0 +1,69 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+#include "../shared.hh"
+#include <sqlite3.h>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// LRU cache of prepared statements keyed by SQL text. \n
+/// A statement taken from the cache (acquire) is marked as busy until it is
+/// given back (release), so the same SQL text may be executed re-entrantly -
+/// the second user simply gets a fresh, uncached statement.
+class StmtCache {
+    struct Entry {
+        std::string sql;
+        sqlite3_stmt* stmt{};
+        bool busy{};
+    };
+    using list_t = std::list<Entry>;
+
+    list_t lru_{};                                              // front = most recently used
+    std::unordered_map<std::string_view, list_t::iterator> index_{};  // keys point into Entry::sql
+    std::size_t capacity_;
+    u64 hits_{};
+    u64 misses_{};
+public:
+    static constexpr std::size_t DefaultCapacity = 32;
+
+    struct Stats {
+        u64 hits{};
+        u64 misses{};
+        std::size_t size{};
+        std::size_t capacity{};
+    };
+
+    explicit StmtCache(std::size_t capacity = DefaultCapacity) : capacity_{capacity} {}
+    ~StmtCache() { clear(); }
+
+    // no copy, no move
+    StmtCache(StmtCache const&) = delete;
+    StmtCache& operator=(StmtCache const&) = delete;
+    StmtCache(StmtCache&&) = delete;
+    StmtCache& operator=(StmtCache&&) = delete;
+
+    /// Get prepared statement for the given SQL text.
+    /// \return statement ready for binding, or nullptr if it could not be prepared.
+    sqlite3_stmt* acquire(sqlite3* db, std::string_view sql) noexcept;
+
+    /// Give back the statement obtained from 'acquire' for the same SQL text. \n
+    /// The statement is reset and its bindings are cleared.
+    void release(std::string_view sql, sqlite3_stmt* stmt) noexcept;
+
+    /// Finalize all idle statements (e.g. before closing the database).
+    void clear() noexcept;
+
+    void capacity(std::size_t n) noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] Stats stats() const noexcept {
+        return {hits_, misses_, lru_.size(), capacity_};
+    }
+
+private:
+    void evict() noexcept;
+};
@@ -0,0 +1,24 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+#include "cursor.hh"
+
+Cursor::Cursor(sqlite3* const db, StmtCache* const cache, query_t query)
+    : state_{std::make_unique<State>(db, cache, std::move(query))}
+{
+    state_->rc = state_->stmt.start(state_->query) ? SQLITE_ROW : SQLITE_ERROR;
+}
+
+std::optional<Row> Cursor::next() noexcept {
+    advance();
+    if (state_->rc == SQLITE_ROW)
+        return std::move(state_->row);
+    return {};
+}
+
+// Step to the next row, unless the end of data (or error) was reached.
+void Cursor::advance() noexcept {
+    if (state_->rc == SQLITE_ROW)
+        state_->rc = state_->stmt.step(state_->row);
+}
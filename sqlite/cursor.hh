@@ -0,0 +1,75 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+#include "stmt.hh"
+#include <iterator>
+#include <memory>
+
+/// Lazy reading of the query result, one row per sqlite3_step. \n
+/// Unlike 'SQLite::select' rows are not collected in memory,
+/// so a cursor can be used to walk over arbitrarily large results:
+/// \code
+///     for (auto&& row : SQLite::instance().cursor(query)) { ... }
+/// \endcode
+class Cursor {
+    // Kept on the heap: the statement refers to the text of the query.
+    struct State {
+        query_t query;
+        Stmt stmt;
+        Row row{};
+        int rc{SQLITE_DONE};
+
+        State(sqlite3* db, StmtCache* cache, query_t q) : query{std::move(q)}, stmt{db, cache} {}
+    };
+    std::unique_ptr<State> state_;
+public:
+    Cursor(sqlite3* db, StmtCache* cache, query_t query);
+    ~Cursor() = default;
+
+    // no copy, default move
+    Cursor(Cursor const&) = delete;
+    Cursor& operator=(Cursor const&) = delete;
+    Cursor(Cursor&&) = default;
+    Cursor& operator=(Cursor&&) = default;
+
+    /// Read the next row.
+    /// \return row, or nothing if there are no more rows (or an error occurred).
+    std::optional<Row> next() noexcept;
+
+    /// Check if reading has stopped because of an error.
+    [[nodiscard]] bool failed() const noexcept {
+        return state_->rc not_eq SQLITE_ROW and state_->rc not_eq SQLITE_DONE;
+    }
+
+    class iterator {
+        Cursor* cursor_{};
+    public:
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(Cursor* cursor) : cursor_{cursor} {}
+
+        Row& operator*() const noexcept { return cursor_->state_->row; }
+        iterator& operator++() noexcept {
+            cursor_->advance();
+            return *this;
+        }
+        void operator++(int) noexcept { ++*this; }
+        bool operator==(std::default_sentinel_t) const noexcept {
+            return cursor_ == nullptr or cursor_->state_->rc not_eq SQLITE_ROW;
+        }
+    };
+
+    /// Start iteration (the first row is read). A cursor can be iterated only once.
+    iterator begin() noexcept {
+        advance();
+        return iterator{this};
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    void advance() noexcept;
+};
@@ -0,0 +1,177 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+#include "functions.hh"
+#include "logger.hh"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <utility>
+
+namespace {
+    /// Elements whose content is not a text of the document.
+    constexpr std::array<std::string_view, 3> SkippedElements{"head", "style", "script"};
+
+    bool iequals(std::string_view const a, std::string_view const b) noexcept {
+        return a.size() == b.size() and std::ranges::equal(a, b, [](unsigned char x, unsigned char y) {
+            return std::tolower(x) == std::tolower(y);
+        });
+    }
+
+    /// Name of the tag (without '/'), text starts after '<'.
+    std::string_view tag_name(std::string_view text) noexcept {
+        if (text.starts_with('/'))
+            text.remove_prefix(1);
+        auto const end = std::ranges::find_if(text, [](unsigned char c) {
+            return not std::isalnum(c);
+        });
+        return text.substr(0, std::size_t(end - text.begin()));
+    }
+
+    void append_utf8(std::string& buffer, char32_t const c) noexcept {
+        if (c < 0x80)
+            buffer += char(c);
+        else if (c < 0x800) {
+            buffer += char(0xc0 | (c >> 6));
+            buffer += char(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x10000) {
+            buffer += char(0xe0 | (c >> 12));
+            buffer += char(0x80 | ((c >> 6) & 0x3f));
+            buffer += char(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x110000) {
+            buffer += char(0xf0 | (c >> 18));
+            buffer += char(0x80 | ((c >> 12) & 0x3f));
+            buffer += char(0x80 | ((c >> 6) & 0x3f));
+            buffer += char(0x80 | (c & 0x3f));
+        }
+    }
+
+    /// Decoding of the entity (text starts after '&').
+    /// \return number of consumed characters (0 if it is not an entity).
+    std::size_t decode_entity(std::string_view const text, std::string& buffer) noexcept {
+        auto const end = text.substr(0, 12).find(';');
+        if (end == std::string_view::npos or end == 0)
+            return 0;
+        auto const name = text.substr(0, end);
+
+        if (name.starts_with('#')) {
+            auto digits = name.substr(1);
+            int base = 10;
+            if (digits.starts_with('x') or digits.starts_with('X')) {
+                digits.remove_prefix(1);
+                base = 16;
+            }
+            std::uint32_t code{};
+            auto const [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), code, base);
+            if (ec != std::errc{} or ptr != digits.data() + digits.size())
+                return 0;
+            append_utf8(buffer, char32_t(code));
+            return end + 1;
+        }
+
+        static constexpr std::array<std::pair<std::string_view, std::string_view>, 6> Entities{{
+            {"amp", "&"}, {"lt", "<"}, {"gt", ">"}, {"quot", "\""}, {"apos", "'"}, {"nbsp", " "}
+        }};
+        for (auto const& [entity, value] : Entities)
+            if (name == entity) {
+                buffer += value;
+                return end + 1;
+            }
+        return 0;
+    }
+
+    void sqlite_strip_html(sqlite3_context* const ctx, int, sqlite3_value** const argv) noexcept {
+        if (sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+            sqlite3_result_null(ctx);
+            return;
+        }
+        auto const ptr{ reinterpret_cast<char const*>(sqlite3_value_text(argv[0]))};
+        auto const size{ sqlite3_value_bytes(argv[0])};
+        auto const text = sql::strip_html({ptr, std::size_t(size)});
+        sqlite3_result_text(ctx, text.data(), int(text.size()), SQLITE_TRANSIENT);
+    }
+}
+
+namespace sql {
+    std::string strip_html(std::string_view html) noexcept {
+        std::string buffer{};
+        buffer.reserve(html.size());
+        bool space = false;
+
+        auto const append_space = [&] {
+            space = not buffer.empty();
+        };
+
+        while (not html.empty()) {
+            auto const c = html.front();
+            if (c == '<') {
+                // comment
+                if (html.starts_with("<!--")) {
+                    auto const end = html.find("-->");
+                    html.remove_prefix(end == std::string_view::npos ? html.size() : end + 3);
+                    continue;
+                }
+                auto const name = tag_name(html.substr(1));
+                auto const end = html.find('>');
+                if (end == std::string_view::npos)
+                    break;
+                auto const closing = html[1] == '/';
+                html.remove_prefix(end + 1);
+
+                // The whole content of skipped elements is omitted.
+                if (not closing and std::ranges::any_of(SkippedElements, [name](auto e) { return iequals(e, name); })) {
+                    std::string_view rest = html;
+                    std::size_t pos = 0;
+                    while ((pos = rest.find("</", pos)) != std::string_view::npos) {
+                        if (iequals(tag_name(rest.substr(pos + 1)), name))
+                            break;
+                        pos += 2;
+                    }
+                    if (pos == std::string_view::npos) {
+                        html = {};
+                        break;
+                    }
+                    html.remove_prefix(pos);
+                    html.remove_prefix(std::min(html.find('>'), html.size() - 1) + 1);
+                }
+                // Tags separate words (e.g. </p><p>, <br>).
+                append_space();
+                continue;
+            }
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                append_space();
+                html.remove_prefix(1);
+                continue;
+            }
+
+            if (space) {
+                buffer += ' ';
+                space = false;
+            }
+            if (c == '&') {
+                if (auto const n = decode_entity(html.substr(1), buffer); n) {
+                    html.remove_prefix(n + 1);
+                    continue;
+                }
+            }
+            buffer += c;
+            html.remove_prefix(1);
+        }
+        return buffer;
+    }
+
+    bool register_functions(sqlite3* const db) noexcept {
+        // Deterministic and innocuous. Not used in the schema - other clients
+        // of the database (e.g. the sqlite3 shell) do not have it.
+        auto const flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS;
+        if (SQLITE_OK == sqlite3_create_function_v2(db, "strip_html", 1, flags, nullptr, sqlite_strip_html, nullptr, nullptr, nullptr))
+            return true;
+        LOG_ERROR(db);
+        return false;
+    }
+}
@@ -0,0 +1,22 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+
+namespace sql {
+    /// Text of the HTML document without markup. \n
+    /// Tags, comments and the content of <head>, <style> and <script> are removed,
+    /// entities are decoded and runs of white characters become one space.
+    std::string strip_html(std::string_view html) noexcept;
+
+    /// Registration of the application functions on the database connection:
+    ///     strip_html(text) - see above (fills the full-text search index). \n
+    /// The functions exist only on connections of this program, so they are used
+    /// only in its own statements - never in the schema (views, triggers,
+    /// indexes), which must stay usable by any SQLite client.
+    bool register_functions(sqlite3* db) noexcept;
+}
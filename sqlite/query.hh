@@ -11,8 +11,9 @@ public:
     query_t() = default;
     /// Query for name and arguments with fold-expression
     template<typename... T>
-    explicit query_t(std::string query, T... args) : query_{std::move(query)} {
-        (..., values_.push_back(value_t(args)));
+    explicit query_t(std::string query, T&&... args) : query_{std::move(query)} {
+        values_.reserve(sizeof...(T));
+        (..., values_.emplace_back(std::forward<T>(args)));
     }
     /// Query for name (without arguments).
     explicit query_t(std::string query) : query_{std::move(query)} {}
@@ -47,7 +48,7 @@ public:
         return query_;
     }
     /// Get query's arguments.
-    [[nodiscard]] std::vector<value_t> values() const noexcept {
+    [[nodiscard]] std::vector<value_t> const& values() const noexcept {
         return values_;
     }
 };
@@ -6,10 +6,12 @@
 #include "row.hh"
 
 class Result {
+    columns_t columns_{};       // shared by all rows
     std::vector<Row> data_{};
 public:
     Result() = default;
-    explicit Result(Row row) {
+    explicit Result(columns_t columns) : columns_{std::move(columns)} {}
+    explicit Result(Row row) : columns_{row.columns()} {
         data_.push_back(std::move(row));
     }
     ~Result() = default;
@@ -28,7 +30,13 @@ public:
     void push_back(Row row) noexcept {
         data_.push_back(std::move(row));
     }
-    Row operator[](int i) const noexcept {
+    [[nodiscard]] columns_t const& columns() const noexcept {
+        return columns_;
+    }
+    Row& operator[](std::size_t const i) noexcept {
+        return data_[i];
+    }
+    Row const& operator[](std::size_t const i) const noexcept {
         return data_[i];
     }
 
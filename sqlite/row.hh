@@ -4,17 +4,52 @@
 #pragma once
 
 #include "field.hh"
-#include <unordered_map>
+#include <memory>
+#include <string_view>
+
+/// Column names of the query result. \n
+/// One object is shared by all rows of the result.
+class Columns {
+    std::vector<std::string> names_{};
+public:
+    Columns() = default;
+    explicit Columns(std::vector<std::string> names) : names_{std::move(names)} {}
+
+    [[nodiscard]] auto size() const noexcept {
+        return names_.size();
+    }
+    [[nodiscard]] std::string const& name(std::size_t const i) const noexcept {
+        return names_[i];
+    }
+    /// Index of the column with the given name.
+    /// Results have only a few columns, so a linear scan is cheaper than hashing.
+    [[nodiscard]] std::optional<std::size_t> index(std::string_view const name) const noexcept {
+        for (std::size_t i = 0; i < names_.size(); ++i)
+            if (names_[i] == name)
+                return i;
+        return {};
+    }
+    [[nodiscard]] std::shared_ptr<Columns> add(std::string name) const {
+        auto names = names_;
+        names.push_back(std::move(name));
+        return std::make_shared<Columns>(std::move(names));
+    }
+};
+using columns_t = std::shared_ptr<Columns const>;
 
 
 class Row {
-    std::unordered_map<std::string, Field> data_{};
+    columns_t columns_{};
+    std::vector<value_t> values_{};
 public:
     Row() = default;
+    Row(columns_t columns, std::vector<value_t> values)
+        : columns_{std::move(columns)}
+        , values_{std::move(values)} {}
 
     /// Init object with one, initial field.
     Row(std::string const& name, value_t value) {
-        data_[name] = Field{name, std::move(value)};
+        add(name, std::move(value));
     }
 
     ~Row() = default;
@@ -25,30 +60,51 @@ public:
     Row& operator=(Row&&) = default;
 
     [[nodiscard]] bool empty() const noexcept {
-        return data_.empty();
+        return values_.empty();
     }
 
-    std::optional<Field> operator[](std::string const& name) noexcept {
-        if (data_.contains(name))
-            return data_[name];
-        return {};
+    [[nodiscard]] auto size() const noexcept {
+        return values_.size();
     }
 
-    [[nodiscard]] auto size() const noexcept {
-        return data_.size();
+    [[nodiscard]] columns_t const& columns() const noexcept {
+        return columns_;
+    }
+
+    /// Value of the column with the given name (nullptr if there is no such column). \n
+    /// When reading many rows, resolve the index once (Columns::index) and use 'at'.
+    value_t const* operator[](std::string_view const name) const noexcept {
+        if (columns_)
+            if (auto idx = columns_->index(name); idx)
+                return &values_[*idx];
+        return nullptr;
+    }
+    value_t* operator[](std::string_view const name) noexcept {
+        if (columns_)
+            if (auto idx = columns_->index(name); idx)
+                return &values_[*idx];
+        return nullptr;
+    }
+
+    /// Value of the column with the given index (without checking).
+    [[nodiscard]] value_t const& at(std::size_t const i) const& noexcept {
+        return values_[i];
+    }
+    /// Move the value out of the column with the given index (without checking).
+    [[nodiscard]] value_t at(std::size_t const i) && noexcept {
+        return std::move(values_[i]);
     }
 
     Row& add(std::string name, value_t value) noexcept {
-        Field f{std::move(name), std::move(value)};
-        return add(f);
+        columns_ = columns_ ? columns_->add(std::move(name)) : std::make_shared<Columns>(std::vector{std::move(name)});
+        values_.push_back(std::move(value));
+        return *this;
     }
     Row& add(std::string name) noexcept {
-        Field f{std::move(name)};
-        return add(f);
+        return add(std::move(name), value_t{});
     }
     Row& add(Field const& f) noexcept {
-        data_[f.name()] = f;
-        return *this;
+        return add(f.name(), f.value());
     }
 
     template<typename T>
@@ -58,37 +114,27 @@ public:
                : add(name);
     }
 
-    using iterator = std::unordered_map<std::string,Field>::iterator;
-    using const_iterator = std::unordered_map<std::string,Field>::const_iterator;
-    iterator begin() { return data_.begin(); }
-    iterator end() { return data_.end(); }
-    [[maybe_unused]] [[nodiscard]] const_iterator cbegin() const { return data_.cbegin(); }
-    [[maybe_unused]] [[nodiscard]] const_iterator cend() const { return data_.cend(); }
+    using iterator = std::vector<value_t>::iterator;
+    using const_iterator = std::vector<value_t>::const_iterator;
+    iterator begin() { return values_.begin(); }
+    iterator end() { return values_.end(); }
+    [[maybe_unused]] [[nodiscard]] const_iterator cbegin() const { return values_.cbegin(); }
+    [[maybe_unused]] [[nodiscard]] const_iterator cend() const { return values_.cend(); }
 
-    /// Split vector of pairs <name, value> to two vectors. \n
+    /// Split row to two vectors. \n
     /// The first one with names, the second one with values.
     [[nodiscard]] std::pair<std::vector<std::string>,std::vector<value_t>> split() const noexcept {
         std::vector<std::string> names{};
-        std::vector<value_t> values{};
-
-        if (not data_.empty()) {
-            auto const n = data_.size();
-            names.reserve(n);
-            values.reserve(n);
-
-            for (auto const& it : data_) {
-                names.push_back(it.second.name());
-                values.push_back(it.second.value());
-            }
-        }
-
-        return {std::move(names), std::move(values)};
+        names.reserve(values_.size());
+        for (std::size_t i = 0; i < values_.size(); ++i)
+            names.push_back(columns_->name(i));
+        return {std::move(names), values_};
     }
 
     [[nodiscard]] std::string description() const noexcept {
         std::vector<std::string> buffer{};
-        for (const auto & it : data_)
-            buffer.push_back(it.second.description());
+        for (std::size_t i = 0; i < values_.size(); ++i)
+            buffer.push_back(Field(columns_->name(i), values_[i]).description());
         return shared::join(buffer);
     }
 };
@@ -3,16 +3,19 @@
 //
 
 #include "sqlite.hh"
+#include "functions.hh"
 #include <fmt/core.h>
 
 // Close database (if possible).
 bool SQLite::close() noexcept {
     if (db_) {
+        cache_.clear();
         if (sqlite3_close_v2(db_) != SQLITE_OK) {
             LOG_ERROR(db_);
             return false;
         }
         db_ = nullptr;
+        path_.clear();
     }
     return true;
 }
@@ -28,9 +31,19 @@ bool SQLite::open(fs::path const &path, bool const read_only) noexcept {
         return false;
     }
 
-    auto const flags = read_only ? SQLITE_READONLY : SQLITE_OPEN_READWRITE;
+    auto const flags = read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
     auto const database_path = path.string();
     if (SQLITE_OK == sqlite3_open_v2(database_path.c_str(), &db_, flags, nullptr)) {
+        // Application functions (strip_html fills the full-text search index).
+        if (not sql::register_functions(db_)) {
+            close();
+            return false;
+        }
+        path_ = path;
+        if (not configure_connection(read_only)) {
+            close();
+            return false;
+        }
         fmt::print("database opened: {}\n", path.string());
         return true;
     }
@@ -69,6 +82,15 @@ bool SQLite::create(fs::path const &path, std::function<bool(SQLite const&)> con
     auto const flags = SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE;
     auto const database_path = path.string();
     if (SQLITE_OK == sqlite3_open_v2(database_path.c_str(), &db_, flags, nullptr)) {
+        if (not sql::register_functions(db_)) {
+            close();
+            return false;
+        }
+        path_ = path;
+        if (not configure_connection(false)) {
+            close();
+            return false;
+        }
         if (not lambda(*this))
             return false;
         fmt::print("The database created successfully: {}\n", path.string());
@@ -77,3 +99,17 @@ bool SQLite::create(fs::path const &path, std::function<bool(SQLite const&)> con
     LOG_ERROR(db_);
     return false;
 }
+
+// Other threads have their own connections to the same file:
+// wait for their locks and (for the writer) switch the journal to WAL.
+bool SQLite::configure_connection(bool const read_only) const noexcept {
+    sqlite3_busy_timeout(db_, options_.busy_timeout);
+    if (read_only or not options_.wal or path_ == InMemory)
+        return true;
+
+    using JournalModeQuery = sql::query<"PRAGMA journal_mode=WAL", std::string>;
+    if (auto const row = fetch_one<JournalModeQuery>(); row and std::get<0>(*row) == "wal")
+        return true;
+    fmt::print(stderr, "WAL journal mode could not be set\n");
+    return false;
+}
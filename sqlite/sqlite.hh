@@ -6,25 +6,52 @@
 #include "logger.hh"
 #include "../shared.hh"
 #include "stmt.hh"
+#include "cache.hh"
+#include "cursor.hh"
+#include "transaction.hh"
+#include "typed_query.hh"
 #include "query.hh"
 #include <sqlite3.h>
 #include <string>
 #include <array>
 #include <functional>
 
+/// Connection to the database. \n
+/// Every thread has its own connection (instance() is thread local) - SQLite
+/// connections, prepared statements and the statement cache are never shared
+/// between threads. A thread other than the main one opens its connection
+/// with the path of the main database (see path()).
 class SQLite {
     static inline std::array<u8, 16> Header = {
             0x53, 0x51, 0x4c, 0x69, 0x74, 0x65, 0x20, 0x66,
             0x6f, 0x72, 0x6d, 0x61, 0x74, 0x20, 0x33, 0x00
     };
     sqlite3 *db_ = nullptr;
+    fs::path path_{};
+    // Prepared statements reused by all queries (select/insert/update/exec).
+    mutable StmtCache cache_{};
 public:
     static i64 const InvalidRowid = -1;
     static inline std::string InMemory{":memory:"};
 
-    // singleton
+    /// Configuration of connections (set before opening any connection).
+    struct Options {
+        /// Write-ahead log: readers do not block the writer and the writer
+        /// does not block readers (only for database files).
+        bool wal{true};
+        /// How long (milliseconds) a connection waits for a lock held by another connection.
+        int busy_timeout{5000};
+    };
+    static void configure(Options const& options) noexcept {
+        options_ = options;
+    }
+    [[nodiscard]] static Options const& options() noexcept {
+        return options_;
+    }
+
+    // singleton (one per thread)
     static SQLite& instance() noexcept {
-        static SQLite db;
+        static thread_local SQLite db;
         return db;
     }
 
@@ -34,6 +61,10 @@ public:
     // no move
     SQLite(SQLite&&) = delete;
     SQLite& operator=(SQLite&&) = delete;
+    // The connection of a thread is closed when the thread ends.
+    ~SQLite() {
+        close();
+    }
 
     static std::string version() noexcept {
         return sqlite3_version;
@@ -42,45 +73,143 @@ public:
     bool close() noexcept;
     bool open(fs::path const &path, bool read_only = false) noexcept;
     bool create(fs::path const &path, std::function<bool(SQLite const&)> const& lambda, bool override = false) noexcept;
+    /// Path of the opened database (empty if closed).
+    [[nodiscard]] fs::path const& path() const noexcept {
+        return path_;
+    }
+
+    //------- STATEMENT CACHE -----------------------------
+    [[nodiscard]] StmtCache::Stats cache_stats() const noexcept {
+        return cache_.stats();
+    }
+    void cache_capacity(std::size_t const n) noexcept {
+        cache_.capacity(n);
+    }
 
     //------- EXEC ----------------------------------------
     [[nodiscard]] bool exec(query_t const& query) const noexcept {
-        return Stmt(db_).exec_without_result(query);
+        return Stmt(db_, &cache_).exec_without_result(query);
     }
     template<typename... T>
-    [[nodiscard]] bool exec(std::string const& str, T... args) const noexcept {
-        return exec(query_t{str, args...});
+    [[nodiscard]] bool exec(std::string const& str, T&&... args) const noexcept {
+        return exec(query_t{str, std::forward<T>(args)...});
     }
     //------- INSERT --------------------------------------
     [[nodiscard]] i64 insert(query_t const& query) const noexcept {
-        Stmt stmt(db_);
+        Stmt stmt(db_, &cache_);
         if (stmt.exec_without_result(query))
             return sqlite3_last_insert_rowid(db_);
         return InvalidRowid;
     }
     template<typename... T>
-    [[nodiscard]] i64 insert(std::string const& str, T... args) const noexcept {
-        return insert(query_t{str, args...});
+    [[nodiscard]] i64 insert(std::string const& str, T&&... args) const noexcept {
+        return insert(query_t{str, std::forward<T>(args)...});
+    }
+    /// Number of rows modified by the last INSERT, UPDATE or DELETE.
+    [[nodiscard]] int changes() const noexcept {
+        return sqlite3_changes(db_);
     }
     //------- UPDATE --------------------------------------
     [[nodiscard]] bool update(query_t const& query) const noexcept {
-        return Stmt(db_).exec_without_result(query);
+        return Stmt(db_, &cache_).exec_without_result(query);
     }
     template<typename... T>
-    [[nodiscard]] bool update(std::string const& str, T... args) const noexcept {
-        return update(query_t{str, args...});
+    [[nodiscard]] bool update(std::string const& str, T&&... args) const noexcept {
+        return update(query_t{str, std::forward<T>(args)...});
     }
     //------- SELECT --------------------------------------
     [[nodiscard]] std::optional<Result> select(query_t const& query) const noexcept {
-        return Stmt(db_).exec_with_result(query);
+        return Stmt(db_, &cache_).exec_with_result(query);
+    }
+    template<typename... T>
+    [[nodiscard]] std::optional<Result> select(std::string const& str, T&&... args) const noexcept {
+        return select(query_t{str, std::forward<T>(args)...});
+    }
+    //------- CURSOR --------------------------------------
+    /// Rows of the query are read lazily (one by one) while iterating the cursor.
+    [[nodiscard]] Cursor cursor(query_t query) const noexcept {
+        return Cursor(db_, &cache_, std::move(query));
     }
     template<typename... T>
-    [[nodiscard]] std::optional<Result> select(std::string const& str, T... args) const noexcept {
-        return select(query_t{str, args...});
+    [[nodiscard]] Cursor cursor(std::string const& str, T&&... args) const noexcept {
+        return cursor(query_t{str, std::forward<T>(args)...});
+    }
+
+    //------- TRANSACTION ---------------------------------
+    /// Begin a transaction (a savepoint if a transaction is already open).
+    /// The guard commits when it goes out of scope (see transaction.hh).
+    [[nodiscard]] Transaction transaction() const noexcept {
+        return Transaction(db_, &cache_);
+    }
+    /// Is a transaction open?
+    [[nodiscard]] bool in_transaction() const noexcept {
+        return db_ != nullptr and sqlite3_get_autocommit(db_) == 0;
+    }
+
+    //------- TYPED QUERIES (see typed_query.hh) ---------
+    /// Execute the typed query and collect all rows.
+    template<typename Q, typename... Args>
+    [[nodiscard]] std::optional<std::vector<typename Q::row_type>> fetch(Args const&... args) const noexcept {
+        static_assert(sizeof...(Args) == Q::placeholders, "the number of placeholders and arguments does not match");
+        std::vector<typename Q::row_type> rows{};
+        auto const ok = run_typed<Q>([&rows](sqlite3_stmt* const stmt) {
+            rows.push_back(Q::decode(stmt));
+            return true;
+        }, args...);
+        if (ok) return rows;
+        return {};
+    }
+    /// Execute the typed query and return the first row (if any).
+    template<typename Q, typename... Args>
+    [[nodiscard]] std::optional<typename Q::row_type> fetch_one(Args const&... args) const noexcept {
+        static_assert(sizeof...(Args) == Q::placeholders, "the number of placeholders and arguments does not match");
+        std::optional<typename Q::row_type> row{};
+        run_typed<Q>([&row](sqlite3_stmt* const stmt) {
+            row = Q::decode(stmt);
+            return false;
+        }, args...);
+        return row;
+    }
+
+    /// Execute the typed query, each row is passed to 'fn' (rows are not collected).
+    template<typename Q, typename Fn, typename... Args>
+    bool for_each(Fn&& fn, Args const&... args) const noexcept {
+        static_assert(sizeof...(Args) == Q::placeholders, "the number of placeholders and arguments does not match");
+        return run_typed<Q>([&fn](sqlite3_stmt* const stmt) {
+            fn(Q::decode(stmt));
+            return true;
+        }, args...);
     }
 
 private:
+    static Options options_;
+
+    /// Settings of the opened connection (busy timeout, journal mode).
+    bool configure_connection(bool read_only) const noexcept;
+
+    /// Execute the typed query, 'fn' is called for each row as long as it returns true.
+    template<typename Q, typename Fn, typename... Args>
+    bool run_typed(Fn&& fn, Args const&... args) const noexcept {
+        Stmt stmt(db_, &cache_);
+        if (stmt.prepare(Q::sql) and sql::bind_all(stmt.handle(), args...)) {
+            if (sqlite3_column_count(stmt.handle()) == Q::column_count) {
+                int rc;
+                while (SQLITE_ROW == (rc = sqlite3_step(stmt.handle())))
+                    if (not fn(stmt.handle()))
+                        return true;
+                if (SQLITE_DONE == rc)
+                    return true;
+            }
+            else
+                fmt::print(stderr, "The number of columns does not match the query type ({})\n", Q::sql);
+        }
+        LOG_ERROR(db_);
+        return false;
+    }
+
     SQLite() {
         sqlite3_initialize();
     }
 };
+
+inline SQLite::Options SQLite::options_{};
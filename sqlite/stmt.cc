@@ -5,6 +5,7 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "stmt.hh"
+#include "cache.hh"
 #include "logger.hh"
 #include "row.hh"
 #include "value.hh"
@@ -12,94 +13,159 @@
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
-Row fetch_row_data(sqlite3_stmt* stmt, int column_count) noexcept;
+columns_t fetch_columns(sqlite3_stmt* stmt) noexcept;
+Row fetch_row_data(sqlite3_stmt* stmt, columns_t const& columns) noexcept;
 bool bind2stmt(sqlite3_stmt* stmt, std::vector<value_t> const& args) noexcept;
 bool bind_at(sqlite3_stmt* stmt, int idx, value_t const& v) noexcept;
 
-// When statement not finalized do it.
+// When statement not released do it.
 Stmt::~Stmt() {
-    if (stmt_) {
-        if (SQLITE_OK == sqlite3_finalize(stmt_)) {
-            stmt_ = nullptr;
-            return;
-        }
-        LOG_ERROR(db_);
-    }
+    release();
 }
 
 // Execute a query that returns no result.
 bool Stmt::exec_without_result(query_t const& query) noexcept {
     if (query.valid())
-        if (SQLITE_OK == sqlite3_prepare_v2(db_, query.query().c_str(), -1, &stmt_, nullptr))
+        if (prepare(query.query()))
             if (bind2stmt(stmt_, query.values()))
-                if (SQLITE_DONE == sqlite3_step(stmt_))
-                    if (SQLITE_OK == sqlite3_finalize(stmt_)) {
-                        stmt_ = nullptr;
-                        return true;
-                    }
+                if (SQLITE_DONE == sqlite3_step(stmt_)) {
+                    release();
+                    return true;
+                }
 
     LOG_ERROR(db_);
+    release();
     return false;
 }
 
 // Execute a query that returns the result
 std::optional<Result> Stmt::exec_with_result(query_t const& query) noexcept {
     Result result{};
+    int rc = SQLITE_ERROR;
 
     if (query.valid())
-        if (SQLITE_OK == sqlite3_prepare_v2(db_, query.query().c_str(), -1, &stmt_, nullptr))
-            if (bind2stmt(stmt_, query.values()))
+        if (prepare(query.query()))
+            if (bind2stmt(stmt_, query.values())) {
+                rc = SQLITE_DONE;
                 if (auto n = sqlite3_column_count(stmt_); n > 0) {
-                    while (SQLITE_ROW == sqlite3_step(stmt_))
-                        if (auto row = fetch_row_data(stmt_, n); not row.empty())
+                    columns_ = fetch_columns(stmt_);
+                    result = Result(columns_);
+                    while (SQLITE_ROW == (rc = sqlite3_step(stmt_)))
+                        if (auto row = fetch_row_data(stmt_, columns_); not row.empty())
                             result.push_back(std::move(row));
                 }
+            }
 
-    if (SQLITE_DONE == sqlite3_errcode(db_))
-        if (SQLITE_OK == sqlite3_finalize(stmt_)) {
-            stmt_ = nullptr;
-            return std::move(result);
-        }
+    if (SQLITE_DONE == rc) {
+        release();
+        return result;
+    }
 
     LOG_ERROR(db_);
+    release();
     return {};
 }
 
+// Prepare the query for reading row by row.
+bool Stmt::start(query_t const& query) noexcept {
+    if (query.valid())
+        if (prepare(query.query()))
+            if (bind2stmt(stmt_, query.values())) {
+                columns_ = fetch_columns(stmt_);
+                return true;
+            }
+
+    LOG_ERROR(db_);
+    release();
+    return false;
+}
+
+// Read one row of the started query.
+int Stmt::step(Row& row) noexcept {
+    if (stmt_ == nullptr)
+        return SQLITE_MISUSE;
+
+    auto const rc = sqlite3_step(stmt_);
+    if (SQLITE_ROW == rc) {
+        row = fetch_row_data(stmt_, columns_);
+        return rc;
+    }
+    if (SQLITE_DONE not_eq rc)
+        LOG_ERROR(db_);
+    // End of data (or error) - the statement is no longer needed.
+    release();
+    return rc;
+}
+
+// Prepare the statement (or take it from the cache).
+bool Stmt::prepare(std::string_view const sql) noexcept {
+    release();
+    sql_ = sql;
+    if (cache_)
+        stmt_ = cache_->acquire(db_, sql);
+    else   // on error the statement is set to nullptr
+        sqlite3_prepare_v2(db_, sql.data(), static_cast<int>(sql.size()), &stmt_, nullptr);
+    return stmt_ not_eq nullptr;
+}
+
+// Give the statement back to the cache or finalize it.
+void Stmt::release() noexcept {
+    if (stmt_) {
+        if (cache_)
+            cache_->release(sql_, stmt_);
+        else if (SQLITE_OK not_eq sqlite3_finalize(stmt_))
+            LOG_ERROR(db_);
+        stmt_ = nullptr;
+    }
+}
+
 //*******************************************************************
 //*                                                                 *
 //*                        P R I V A T E                            *
 //*                                                                 *
 //*******************************************************************
 
-Row fetch_row_data(sqlite3_stmt* const stmt, int const column_count) noexcept {
-    Row row{};
+// Column names are read once per statement and shared by all rows.
+columns_t fetch_columns(sqlite3_stmt* const stmt) noexcept {
+    auto const n = sqlite3_column_count(stmt);
+    std::vector<std::string> names{};
+    names.reserve(n);
+    for (auto i = 0; i < n; i++)
+        names.emplace_back(sqlite3_column_name(stmt, i));
+    return std::make_shared<Columns const>(std::move(names));
+}
+
+Row fetch_row_data(sqlite3_stmt* const stmt, columns_t const& columns) noexcept {
+    auto const column_count = static_cast<int>(columns->size());
+    std::vector<value_t> values{};
+    values.reserve(column_count);
 
     for (auto i = 0; i < column_count; i++) {
-        std::string name{sqlite3_column_name(stmt, i)};
         switch (sqlite3_column_type(stmt, i)) {
-            case SQLITE_NULL:
-                row.add(std::move(name));
-                break;
             case SQLITE_INTEGER:
-                row.add(std::move(name), sqlite3_column_int64(stmt, i));
+                values.emplace_back(sqlite3_column_int64(stmt, i));
                 break;
             case SQLITE_FLOAT:
-                row.add(std::move(name), sqlite3_column_double(stmt, i));
+                values.emplace_back(sqlite3_column_double(stmt, i));
                 break;
             case SQLITE_TEXT: {
-                std::string text{reinterpret_cast<const char *>(sqlite3_column_text(stmt, i))};
-                row.add(std::move(name), std::move(text));
+                auto const ptr{ reinterpret_cast<const char *>(sqlite3_column_text(stmt, i))};
+                auto const size{ sqlite3_column_bytes(stmt, i)};
+                values.emplace_back(std::string{ptr, static_cast<std::size_t>(size)});
                 break;
             }
             case SQLITE_BLOB: {
                 auto const ptr { reinterpret_cast<u8 const*>(sqlite3_column_blob(stmt, i))};
                 auto const size{ sqlite3_column_bytes(stmt, i)};
                 std::vector<u8> vec{ ptr, ptr + size };
-                row.add(std::move(name), std::move(vec));
+                values.emplace_back(std::move(vec));
+                break;
             }
+            default:    // SQLITE_NULL
+                values.emplace_back();
         }
     }
-    return row;
+    return {columns, std::move(values)};
 }
 
 bool bind2stmt(sqlite3_stmt* const stmt, std::vector<value_t> const& args) noexcept {
@@ -112,6 +178,8 @@ bool bind2stmt(sqlite3_stmt* const stmt, std::vector<value_t> const& args) noexc
     return true;
 }
 
+// The arguments live in the query until the statement is released
+// (bindings are cleared then), so SQLite does not have to copy them.
 bool bind_at(sqlite3_stmt* const stmt, int const idx, value_t const& v) noexcept {
     switch (v.index()) {
         case value_t::Monostate:
@@ -120,13 +188,15 @@ bool bind_at(sqlite3_stmt* const stmt, int const idx, value_t const& v) noexcept
             return SQLITE_OK == sqlite3_bind_int64(stmt, idx, v.int64());
         case value_t::Double:
             return SQLITE_OK == sqlite3_bind_double(stmt, idx, v.float64());
-        case value_t::String: {
-            auto const text{ v.str() };
-            return SQLITE_OK == sqlite3_bind_text(stmt, idx, text.c_str(), -1, SQLITE_TRANSIENT); }
-            case value_t::Vector: {
-            auto const vec{ v.vec() };
-            auto const n{ static_cast<int>(vec.size())};
-            return SQLITE_OK == sqlite3_bind_blob(stmt, idx, vec.data(), n, SQLITE_TRANSIENT); }
+        case value_t::String:
+        case value_t::StringRef: {
+            auto const text{ v.str_view() };
+            auto const n{ static_cast<int>(text.size())};
+            return SQLITE_OK == sqlite3_bind_text(stmt, idx, text.data(), n, SQLITE_STATIC); }
+        case value_t::Vector: {
+            auto const bytes{ v.bytes() };
+            auto const n{ static_cast<int>(bytes.size())};
+            return SQLITE_OK == sqlite3_bind_blob(stmt, idx, bytes.data(), n, SQLITE_STATIC); }
         default:
             return false;
     }
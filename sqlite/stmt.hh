@@ -4,23 +4,48 @@
 #pragma once
 
 #include <optional>
+#include <string_view>
 #include <sqlite3.h>
 #include "query.hh"
 #include "result.hh"
 
+class StmtCache;
+
 class Stmt {
     sqlite3* db_{};
+    StmtCache* cache_{};
     sqlite3_stmt* stmt_{};
+    std::string_view sql_{};
+    columns_t columns_{};       // column names of the prepared statement
 public:
     Stmt() = delete;
-    explicit Stmt(sqlite3* db) : db_{db} {}
+    /// \param db - database connection,
+    /// \param cache - if given, prepared statements are taken from and returned to the cache.
+    explicit Stmt(sqlite3* db, StmtCache* cache = nullptr) : db_{db}, cache_{cache} {}
     ~Stmt();
 
-    Stmt(Stmt const&) = default;
-    Stmt(Stmt&&) = default;
-    Stmt& operator=(Stmt const&) = default;
-    Stmt& operator=(Stmt&&) = default;
+    // no copy (the statement is owned), no move
+    Stmt(Stmt const&) = delete;
+    Stmt(Stmt&&) = delete;
+    Stmt& operator=(Stmt const&) = delete;
+    Stmt& operator=(Stmt&&) = delete;
 
     bool exec_without_result(query_t const& query) noexcept;
     std::optional<Result> exec_with_result(query_t const& query) noexcept;
+
+    /// Prepare the query and bind its arguments for reading row by row (see 'step'). \n
+    /// The query must outlive the statement.
+    bool start(query_t const& query) noexcept;
+    /// Read the next row of the started query.
+    /// \return SQLITE_ROW if 'row' was filled, SQLITE_DONE at the end of data, or error code.
+    int step(Row& row) noexcept;
+
+    /// Prepare the statement (or take it from the cache) without binding arguments. \n
+    /// The SQL text must outlive the statement.
+    bool prepare(std::string_view sql) noexcept;
+    /// Give the statement back to the cache or finalize it.
+    void release() noexcept;
+    [[nodiscard]] sqlite3_stmt* handle() const noexcept {
+        return stmt_;
+    }
 };
@@ -0,0 +1,75 @@
+//
+// Created by piotr on 17.10.26.
+//
+
+#include "transaction.hh"
+#include <exception>
+#include <fmt/core.h>
+
+// Depth of nested savepoints of the connection (every thread has its own connection).
+static thread_local int depth{};
+
+Transaction::Transaction(sqlite3* const db, StmtCache* const cache) noexcept
+    : db_{db}
+    , cache_{cache}
+    , exceptions_{std::uncaught_exceptions()}
+{
+    if (db_ == nullptr)
+        return;
+    // Transaction is already open (autocommit is off) - savepoint inside it.
+    if (sqlite3_get_autocommit(db_) == 0)
+        savepoint_ = fmt::format("sp{}", depth + 1);
+
+    active_ = exec(nested() ? "SAVEPOINT " + savepoint_ : "BEGIN IMMEDIATE");
+    if (active_ and nested())
+        ++depth;
+}
+
+Transaction::Transaction(Transaction&& other) noexcept
+    : db_{other.db_}
+    , cache_{other.cache_}
+    , savepoint_{std::move(other.savepoint_)}
+    , exceptions_{other.exceptions_}
+    , active_{other.active_}
+{
+    other.active_ = false;
+}
+
+Transaction::~Transaction() {
+    if (not active_)
+        return;
+    if (std::uncaught_exceptions() > exceptions_)
+        rollback();
+    else
+        commit();
+}
+
+bool Transaction::commit() noexcept {
+    if (not active_)
+        return false;
+    if (exec(nested() ? "RELEASE " + savepoint_ : "COMMIT")) {
+        finish();
+        return true;
+    }
+    rollback();
+    return false;
+}
+
+void Transaction::rollback() noexcept {
+    if (not active_)
+        return;
+    if (nested()) {
+        // ROLLBACK TO leaves the savepoint open - it must be released too.
+        (void)exec("ROLLBACK TO " + savepoint_);
+        (void)exec("RELEASE " + savepoint_);
+    }
+    else
+        (void)exec("ROLLBACK");
+    finish();
+}
+
+void Transaction::finish() noexcept {
+    active_ = false;
+    if (nested())
+        --depth;
+}
@@ -0,0 +1,56 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+#include "stmt.hh"
+#include <string>
+
+/// Transaction (or savepoint) guard. \n
+/// The outermost guard begins a transaction (BEGIN IMMEDIATE), a guard created
+/// while a transaction is open begins a savepoint, so operations can be nested.
+/// The guard commits when it goes out of scope (rolls back if an exception
+/// is in flight); on error it must be rolled back explicitly:
+/// \code
+///     auto tx = SQLite::instance().transaction();
+///     if (not tx) return false;
+///     if (not db.exec(...)) { tx.rollback(); return false; }
+///     return tx.commit();
+/// \endcode
+class Transaction {
+    sqlite3* db_;
+    StmtCache* cache_;
+    std::string savepoint_{};   // empty - transaction, otherwise the name of the savepoint
+    int exceptions_{};
+    bool active_{};
+public:
+    Transaction(sqlite3* db, StmtCache* cache) noexcept;
+    ~Transaction();
+
+    // no copy, move only by construction
+    Transaction(Transaction const&) = delete;
+    Transaction& operator=(Transaction const&) = delete;
+    Transaction(Transaction&& other) noexcept;
+    Transaction& operator=(Transaction&&) = delete;
+
+    /// Was the transaction (savepoint) started and is it still open?
+    explicit operator bool() const noexcept {
+        return active_;
+    }
+    /// Is it a savepoint inside another transaction?
+    [[nodiscard]] bool nested() const noexcept {
+        return not savepoint_.empty();
+    }
+
+    /// Commit the transaction (release the savepoint). \n
+    /// If the commit fails, the transaction is rolled back.
+    bool commit() noexcept;
+    /// Roll back all changes made since the transaction (savepoint) began.
+    void rollback() noexcept;
+
+private:
+    bool exec(std::string const& sql) const noexcept {
+        return Stmt(db_, cache_).exec_without_result(query_t{sql});
+    }
+    void finish() noexcept;
+};
@@ -0,0 +1,151 @@
+//
+// Created by piotr on 17.10.26.
+//
+#pragma once
+
+#include "../shared.hh"
+#include "value.hh"
+#include <sqlite3.h>
+#include <algorithm>
+#include <concepts>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Queries checked at compile time. \n
+/// The SQL text is a template argument, so the number of placeholders is counted
+/// by the compiler, and the result columns are decoded by position straight into
+/// a tuple (or any type constructible from the column values):
+/// \code
+///     using ByID = sql::query<"SELECT pid, name FROM category WHERE id=?", i64, std::string>;
+///     if (auto row = SQLite::instance().fetch_one<ByID>(id)) { auto [pid, name] = *row; ... }
+/// \endcode
+/// A wrong number of arguments does not compile.
+namespace sql {
+    /// SQL text which can be used as a template argument.
+    template<std::size_t N>
+    struct text {
+        char data[N]{};
+
+        consteval text(char const (&str)[N]) {
+            std::copy_n(str, N, data);
+        }
+        [[nodiscard]] constexpr std::string_view view() const noexcept {
+            return {data, N - 1};
+        }
+        /// Number of placeholders (?) - question marks inside quoted literals are skipped.
+        [[nodiscard]] consteval std::size_t placeholders() const noexcept {
+            std::size_t n{};
+            char quote{};
+            for (std::size_t i = 0; i < N - 1; ++i) {
+                auto const c = data[i];
+                if (quote) {
+                    if (c == quote) quote = 0;
+                }
+                else if (c == '\'' or c == '"')
+                    quote = c;
+                else if (c == '?')
+                    ++n;
+            }
+            return n;
+        }
+    };
+
+    /// Query with the given SQL text and result column types.
+    /// Rows are created as 'Target' from the values of the columns (in order).
+    template<text Sql, typename Target, typename... Columns>
+    struct typed_query {
+        using row_type = Target;
+        static constexpr std::string_view sql = Sql.view();
+        static constexpr std::size_t placeholders = Sql.placeholders();
+        static constexpr int column_count = sizeof...(Columns);
+
+        /// Decode the current row of the statement.
+        static Target decode(sqlite3_stmt* stmt) noexcept {
+            return decode(stmt, std::make_index_sequence<sizeof...(Columns)>{});
+        }
+    private:
+        template<std::size_t... I>
+        static Target decode(sqlite3_stmt* stmt, std::index_sequence<I...>) noexcept;
+    };
+
+    /// Query whose rows are tuples of column values.
+    template<text Sql, typename... Columns>
+    using query = typed_query<Sql, std::tuple<Columns...>, Columns...>;
+
+    /// Query whose rows are objects of type T (e.g. Note, Category).
+    template<typename T, text Sql, typename... Columns>
+    using query_as = typed_query<Sql, T, Columns...>;
+
+    //------- column decoding ----------------------------
+    template<typename T> struct is_optional : std::false_type {};
+    template<typename T> struct is_optional<std::optional<T>> : std::true_type {};
+
+    template<typename T>
+    T column(sqlite3_stmt* const stmt, int const i) noexcept {
+        if constexpr (is_optional<T>::value) {
+            if (sqlite3_column_type(stmt, i) == SQLITE_NULL)
+                return {};
+            return column<typename T::value_type>(stmt, i);
+        }
+        else if constexpr (std::integral<T>)
+            return static_cast<T>(sqlite3_column_int64(stmt, i));
+        else if constexpr (std::floating_point<T>)
+            return static_cast<T>(sqlite3_column_double(stmt, i));
+        else if constexpr (std::same_as<T, std::string>) {
+            auto const ptr{ reinterpret_cast<char const*>(sqlite3_column_text(stmt, i))};
+            auto const size{ sqlite3_column_bytes(stmt, i)};
+            return ptr ? std::string{ptr, static_cast<std::size_t>(size)} : std::string{};
+        }
+        else if constexpr (std::same_as<T, std::vector<u8>>) {
+            auto const ptr{ reinterpret_cast<u8 const*>(sqlite3_column_blob(stmt, i))};
+            auto const size{ sqlite3_column_bytes(stmt, i)};
+            return ptr ? std::vector<u8>{ptr, ptr + size} : std::vector<u8>{};
+        }
+        else
+            static_assert(sizeof(T) == 0, "unsupported column type");
+    }
+
+    template<text Sql, typename Target, typename... Columns>
+    template<std::size_t... I>
+    Target typed_query<Sql, Target, Columns...>::decode(sqlite3_stmt* const stmt, std::index_sequence<I...>) noexcept {
+        // Braced list - columns are read in order.
+        std::tuple<Columns...> values{column<Columns>(stmt, int(I))...};
+        if constexpr (std::same_as<Target, std::tuple<Columns...>>)
+            return values;
+        else
+            return std::make_from_tuple<Target>(std::move(values));
+    }
+
+    //------- argument binding ----------------------------
+    // Arguments are alive for the whole execution (bindings are cleared
+    // when the statement is released), so text is not copied by SQLite.
+    template<typename T>
+    bool bind(sqlite3_stmt* const stmt, int const idx, T const& v) noexcept {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (is_optional<U>::value)
+            return v ? bind(stmt, idx, *v) : SQLITE_OK == sqlite3_bind_null(stmt, idx);
+        else if constexpr (std::integral<U>)
+            return SQLITE_OK == sqlite3_bind_int64(stmt, idx, static_cast<i64>(v));
+        else if constexpr (std::floating_point<U>)
+            return SQLITE_OK == sqlite3_bind_double(stmt, idx, static_cast<f64>(v));
+        else if constexpr (std::convertible_to<U const&, std::string_view>) {
+            std::string_view const text{v};
+            return SQLITE_OK == sqlite3_bind_text(stmt, idx, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+        }
+        else if constexpr (std::same_as<U, std::vector<u8>>)
+            return SQLITE_OK == sqlite3_bind_blob(stmt, idx, v.data(), static_cast<int>(v.size()), SQLITE_STATIC);
+        else
+            static_assert(sizeof(U) == 0, "unsupported argument type");
+    }
+
+    template<typename... Args>
+    bool bind_all([[maybe_unused]] sqlite3_stmt* const stmt, Args const&... args) noexcept {
+        int idx{};
+        return (... and bind(stmt, ++idx, args));
+    }
+}
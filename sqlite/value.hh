@@ -7,10 +7,10 @@
 #include <variant>
 
 class value_t {
-    std::variant<std::monostate, i64, f64, std::string, std::vector<u8>> data_{};
+    std::variant<std::monostate, i64, f64, std::string, std::vector<u8>, std::string_view> data_{};
 public:
     enum {
-        Monostate, Integer, Double, String, Vector
+        Monostate, Integer, Double, String, Vector, StringRef
     };
 
     value_t() = default;
@@ -20,6 +20,15 @@ public:
     value_t(std::vector<u8> v) : data_{std::move(v)} {}
     ~value_t() = default;
 
+    /// Text which is not copied (e.g. the content of a note passed as a query argument). \n
+    /// The string must outlive the query.
+    static value_t ref(std::string const& v) noexcept {
+        value_t value{};
+        value.data_ = std::string_view{v};
+        return value;
+    }
+    static value_t ref(std::string&&) = delete;
+
     template<typename T>
     explicit value_t(std::optional<T> v) {
         if (v) data_ = v.value();
@@ -56,10 +65,28 @@ public:
     [[nodiscard]] f64 float64() const noexcept {
         return std::get<Double>(data_);
     }
-    [[nodiscard]] std::string str() const noexcept {
+    [[nodiscard]] std::string const& str() const& noexcept {
+        return std::get<String>(data_);
+    }
+    /// Move the text out of the value.
+    [[nodiscard]] std::string str() && noexcept {
+        return std::move(std::get<String>(data_));
+    }
+    /// Text without copying (owned or borrowed).
+    [[nodiscard]] std::string_view str_view() const noexcept {
+        if (data_.index() == StringRef)
+            return std::get<StringRef>(data_);
         return std::get<String>(data_);
     }
-    [[nodiscard]] std::vector<u8> vec() const noexcept {
+    [[nodiscard]] std::vector<u8> const& vec() const& noexcept {
+        return std::get<Vector>(data_);
+    }
+    /// Move the bytes out of the value.
+    [[nodiscard]] std::vector<u8> vec() && noexcept {
+        return std::move(std::get<Vector>(data_));
+    }
+    /// Bytes without copying.
+    [[nodiscard]] std::span<u8 const> bytes() const noexcept {
         return std::get<Vector>(data_);
     }
 
@@ -95,7 +122,8 @@ public:
             case Double:
                 return fmt::format("double{{{}}}", std::get<Double>(data_));
             case String:
-                return fmt::format("string{{{}}}", std::get<String>(data_));
+            case StringRef:
+                return fmt::format("string{{{}}}", str_view());
             case Vector: {
                 auto vec = std::get<Vector>(data_);
                 return fmt::format("blob{{{}}}", shared::bytes2str(vec));